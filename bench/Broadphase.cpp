@@ -0,0 +1,96 @@
+/**
+ * @file    Broadphase.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Broadphase benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CGame.h"
+
+#include <cmath>
+#include <cstdio>
+
+TD_BENCHMARK(broadphase, "Broadphase insert/update/remove cost at 1k/10k/50k proxies")
+{
+    static const uint counts[] = { 1000, 10000, 50000 };
+    static const char* types[] = { "axis_sweep", "dbvt" };
+    const uint updates = 20;
+
+    btDefaultCollisionConfiguration config;
+    btCollisionDispatcher dispatcher(&config);
+    btSphereShape shape(1.0f);
+    char label[96];
+
+    for( uint t = 0; t < sizeof(types) / sizeof(types[0]); t++ )
+    {
+        for( uint c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ )
+        {
+            const uint count = counts[c];
+
+            // Sparse grid, spheres touch only some neighbours
+            const uint side = static_cast<uint>(std::ceil(std::pow(static_cast<double>(count), 1.0 / 3.0)));
+            const btScalar step = 2.5f;
+
+            pugi::xml_document doc;
+            pugi::xml_node node = doc.append_child("broadphase");
+            node.append_child("type").append_child(pugi::node_pcdata).set_value(types[t]);
+            node.append_child("min").append_child(pugi::node_pcdata).set_value("-10000 -10000 -10000");
+            node.append_child("max").append_child(pugi::node_pcdata).set_value("10000 10000 10000");
+            node.append_child("max_handles").append_child(pugi::node_pcdata).set_value(Ogre::StringConverter::toString(count + 1).c_str());
+
+            btBroadphaseInterface* broadphase = CWorld::createBroadphase(node);
+            btCollisionWorld* world = new btCollisionWorld(&dispatcher, broadphase, &config);
+
+            std::vector<btCollisionObject*> objects;
+            for( uint i = 0; i < count; i++ )
+            {
+                btCollisionObject* obj = new btCollisionObject();
+                obj->setCollisionShape(&shape);
+                obj->getWorldTransform().setOrigin(btVector3(static_cast<btScalar>(i % side) * step,
+                                                             static_cast<btScalar>((i / side) % side) * step,
+                                                             static_cast<btScalar>(i / (side * side)) * step));
+                objects.push_back(obj);
+            }
+
+            // Insert
+            unsigned long start = bench.now();
+            for( uint i = 0; i < count; i++ )
+                world->addCollisionObject(objects[i]);
+            std::snprintf(label, sizeof(label), "%s %u insert", types[t], count);
+            bench.result(label, static_cast<double>(bench.now() - start) / count, "usec/proxy");
+
+            // Update: every object moves, pairs are recalculated
+            start = bench.now();
+            for( uint u = 0; u < updates; u++ )
+            {
+                btVector3 shift((u % 2) ? 0.5f : -0.5f, 0.0f, 0.0f);
+                for( uint i = 0; i < count; i++ )
+                    objects[i]->getWorldTransform().getOrigin() += shift;
+                world->updateAabbs();
+                broadphase->calculateOverlappingPairs(&dispatcher);
+            }
+            std::snprintf(label, sizeof(label), "%s %u update", types[t], count);
+            bench.result(label, static_cast<double>(bench.now() - start) / updates, "usec/frame");
+
+            // Remove
+            start = bench.now();
+            for( uint i = count; i > 0; i-- )
+                world->removeCollisionObject(objects[i - 1]);
+            std::snprintf(label, sizeof(label), "%s %u remove", types[t], count);
+            bench.result(label, static_cast<double>(bench.now() - start) / count, "usec/proxy");
+
+            for( uint i = 0; i < count; i++ )
+                delete objects[i];
+            delete world;
+            delete broadphase;
+        }
+    }
+}
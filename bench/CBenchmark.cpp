@@ -0,0 +1,146 @@
+/**
+ * @file    CBenchmark.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Benchmark scenarios registry
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <algorithm>
+
+CBenchmark::CBenchmark(const char* name, const char* description, Function function)
+    : m_Name(name)
+    , m_Description(description)
+    , m_Function(function)
+    , m_Timer()
+    , m_Executed(false)
+    , m_Time(0.0)
+    , m_Results()
+{
+    registry().push_back(this);
+}
+
+CBenchmark::~CBenchmark()
+{
+    std::vector<CBenchmark*>& benchmarks = registry();
+    benchmarks.erase(std::remove(benchmarks.begin(), benchmarks.end(), this), benchmarks.end());
+}
+
+std::vector<CBenchmark*>& CBenchmark::registry()
+{
+    // Static objects of other units may register before any global of this unit
+    static std::vector<CBenchmark*> benchmarks;
+    return benchmarks;
+}
+
+bool CBenchmark::run(const char* name)
+{
+    if( std::strcmp(name, "list") == 0 )
+    {
+        list();
+        return true;
+    }
+
+    bool found = false;
+    std::vector<CBenchmark*>& benchmarks = registry();
+    for( std::vector<CBenchmark*>::iterator it = benchmarks.begin(); it != benchmarks.end(); it++ )
+    {
+        if( (std::strcmp(name, "all") == 0) || (std::strcmp(name, (*it)->name()) == 0) )
+        {
+            (*it)->execute();
+            found = true;
+        }
+    }
+
+    if( ! found )
+    {
+        list();
+        return log_error("Benchmark \"%s\" not found", name);
+    }
+
+    return true;
+}
+
+void CBenchmark::list()
+{
+    std::vector<CBenchmark*>& benchmarks = registry();
+    log_notice("Available benchmarks:");
+    for( std::vector<CBenchmark*>::iterator it = benchmarks.begin(); it != benchmarks.end(); it++ )
+        log_notice("  %s - %s", (*it)->m_Name, (*it)->m_Description);
+}
+
+void CBenchmark::execute()
+{
+    log_notice("Benchmark %s: %s", m_Name, m_Description);
+
+    m_Results.clear();
+    m_Timer.reset();
+    m_Function(*this);
+    m_Time = static_cast<double>(now()) / 1000000.0;
+    m_Executed = true;
+
+    log_notice("Benchmark %s done in %.3f sec", m_Name, m_Time);
+}
+
+void CBenchmark::result(const char* label, double value, const char* unit)
+{
+    log_notice("  %s: %s = %.4f %s", m_Name, label, value, unit);
+
+    m_Results.push_back(SResult(label, value, unit));
+}
+
+bool CBenchmark::writeJson(const char* path)
+{
+    FILE* file = std::fopen(path, "w");
+    if( file == NULL )
+        return log_error("Can't create benchmark results \"%s\"", path);
+
+    // Labels and units are plain text without quotes
+    std::fprintf(file, "{\n  \"version\": \"%s\",\n  \"time\": %ld,\n  \"benchmarks\": [", CONFIG_TD_VERSION,
+                 static_cast<long>(std::time(NULL)));
+    bool first = true;
+    std::vector<CBenchmark*>& benchmarks = registry();
+    for( std::vector<CBenchmark*>::iterator it = benchmarks.begin(); it != benchmarks.end(); it++ )
+    {
+        if( ! (*it)->m_Executed )
+            continue;
+
+        std::fprintf(file, "%s\n    {\n      \"name\": \"%s\",\n      \"seconds\": %.6f,\n      \"results\": [",
+                     first ? "" : ",", (*it)->m_Name, (*it)->m_Time);
+        first = false;
+
+        for( size_t i = 0; i < (*it)->m_Results.size(); i++ )
+        {
+            const SResult& res = (*it)->m_Results[i];
+            std::fprintf(file, "%s\n        { \"label\": \"%s\", \"value\": ", (i == 0) ? "" : ",", res.m_Label.c_str());
+
+            // JSON has no inf and nan
+            if( std::isfinite(res.m_Value) )
+                std::fprintf(file, "%.6g", res.m_Value);
+            else
+                std::fprintf(file, "null");
+            std::fprintf(file, ", \"unit\": \"%s\" }", res.m_Unit.c_str());
+        }
+        std::fprintf(file, "\n      ]\n    }");
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+
+    if( std::fclose(file) != 0 )
+        return log_error("Can't write benchmark results \"%s\"", path);
+
+    log_notice("Benchmark results written to \"%s\"", path);
+
+    return true;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file    CBenchmark.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Benchmark scenarios registry
+ *
+ *
+ */
+
+#ifndef CBENCHMARK_H
+#define CBENCHMARK_H
+
+#include "Common.h"
+
+/** @brief Named benchmark scenario
+ *
+ *  Scenarios are registered by static objects (see TD_BENCHMARK) and
+ * started by td_bench after headless game initialisation ("all" - run
+ * every scenario, "list" - show available). Static objects are dropped
+ * by linker from static libraries, so scenarios are linked into td_bench
+ * as object files.
+ */
+class CBenchmark
+{
+public:
+    typedef void (*Function)(CBenchmark& bench); ///< Scenario function
+
+    /** @brief Register scenario
+     *
+     * @param name - Scenario name
+     * @param description - Short description
+     * @param function - Scenario function
+     */
+    CBenchmark(const char* name, const char* description, Function function);
+
+    /** @brief Destructor
+     */
+    ~CBenchmark();
+
+    /** @brief Run scenario by name
+     *
+     * @param name - Scenario name, "all" or "list"
+     * @return bool - false if scenario not found
+     */
+    static bool run(const char* name);
+
+    /** @brief Log available scenarios
+     */
+    static void list();
+
+    /** @brief Write results of executed scenarios
+     *
+     * @param path - Path to json file
+     * @return bool
+     */
+    static bool writeJson(const char* path);
+
+    /** @brief Get scenario name
+     *
+     * @return const char*
+     */
+    inline const char* name() const { return m_Name; }
+
+    /** @brief Current benchmark time
+     *
+     * @return unsigned long - Microseconds
+     */
+    inline unsigned long now() { return m_Timer.getMicroseconds(); }
+
+    /** @brief Report one measured value
+     *
+     * @param label - What was measured
+     * @param value - Measured value
+     * @param unit - Unit of value
+     */
+    void result(const char* label, double value, const char* unit);
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CBenchmark(const CBenchmark& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CBenchmark& operator=(const CBenchmark& obj);
+
+    /** @brief List of registered scenarios
+     *
+     * @return std::vector<CBenchmark*>&
+     */
+    static std::vector<CBenchmark*>& registry();
+
+    /** @brief One measured value
+     */
+    struct SResult
+    {
+        SResult(const char* label, double value, const char* unit) : m_Label(label), m_Value(value), m_Unit(unit) {  }
+
+        std::string     m_Label; ///< What was measured
+        double          m_Value; ///< Measured value
+        std::string     m_Unit;  ///< Unit of value
+    };
+
+    /** @brief Execute this scenario
+     */
+    void execute();
+
+    const char*         m_Name;        ///< Scenario name
+    const char*         m_Description; ///< Scenario description
+    Function            m_Function;    ///< Scenario function
+    Ogre::Timer         m_Timer;       ///< Scenario timer
+    bool                m_Executed;    ///< Scenario was executed
+    double              m_Time;        ///< Execution time (seconds)
+    std::vector<SResult> m_Results;    ///< Measured values
+};
+
+/** @brief Define and register benchmark scenario
+ *
+ * Scenario body gets "CBenchmark& bench" argument.
+ */
+#define TD_BENCHMARK(name, description) \
+    static void bench_##name(CBenchmark& bench); \
+    static CBenchmark s_Bench_##name(#name, description, bench_##name); \
+    static void bench_##name(CBenchmark& bench)
+
+#endif // CBENCHMARK_H
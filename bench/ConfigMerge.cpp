@@ -0,0 +1,154 @@
+/**
+ * @file    ConfigMerge.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   XML data load and merge benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CData.h"
+#include "CGame.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+/** @brief Write data file with sections of options
+ *
+ * @param path - Data file path
+ * @param sections - Number of sections
+ * @param options - Options in every section
+ * @param shift - Value shift, different for base and overlay files
+ */
+static void writeConfig(const fs::path& path, uint sections, uint options, uint shift)
+{
+    std::ofstream file(path.c_str());
+    file << "<?xml version=\"1.0\"?>\n<" CONFIG_TD_NAME " version=\"" CONFIG_TD_VERSION "\">\n  <Bench>\n";
+    for( uint s = 0; s < sections; s++ )
+    {
+        file << "    <section" << s << ">\n";
+        for( uint o = 0; o < options; o++ )
+            file << "      <option" << o << ">" << (s * options + o + shift) << "</option" << o << ">\n";
+        file << "      <item id=\"" << shift << "\" value=\"" << s << "\"/>\n";
+        file << "    </section" << s << ">\n";
+    }
+    file << "  </Bench>\n</" CONFIG_TD_NAME ">\n";
+}
+
+TD_BENCHMARK(config_merge, "Load of XML data file and merge of overlay file (like user config over global)")
+{
+    static const uint counts[] = { 10, 100, 1000 };
+    const uint options = 10;
+    const uint loads = 20;
+
+    fs::path base = fs::temp_directory_path() / "td_bench_base.xml";
+    fs::path overlay = fs::temp_directory_path() / "td_bench_overlay.xml";
+
+    for( uint c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ )
+    {
+        writeConfig(base, counts[c], options, 0);
+        writeConfig(overlay, counts[c], options, 1);
+
+        unsigned long load_time = 0, merge_time = 0, start;
+        for( uint i = 0; i < loads; i++ )
+        {
+            CData data("Bench");
+
+            start = bench.now();
+            data.loadData(base.c_str());
+            load_time += bench.now() - start;
+
+            start = bench.now();
+            data.loadData(overlay.c_str());
+            merge_time += bench.now() - start;
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "sections %u load", counts[c]);
+        bench.result(label, static_cast<double>(load_time) / loads, "usec");
+        std::snprintf(label, sizeof(label), "sections %u merge", counts[c]);
+        bench.result(label, static_cast<double>(merge_time) / loads, "usec");
+    }
+
+    fs::remove(base);
+    fs::remove(overlay);
+}
+
+TD_BENCHMARK(data_merge, "Load and merge of global config, user skeleton and every object definition")
+{
+    const uint loads = 50;
+    CGame* game = CGame::getInstance();
+
+    fs::path global_config = fs::path(CGame::getPrefix()) / CONFIG_PATH_GLOBAL_CONFIG / "config.xml";
+    fs::path root_data = fs::path(CGame::getPrefix()) / game->path("root_data");
+    fs::path user_skeleton = root_data / game->path("users") / "skeleton" / "user.xml";
+    fs::path user_config = fs::path(game->env("HOME")) / game->path("user_data") / "config.xml";
+
+    // Object definitions are installed as templates, version is set like by cmake
+    static const std::string version_template("${TARGET_VERSION_MAJOR}.${TARGET_VERSION_MINOR}.${TARGET_VERSION_PATCH}");
+    std::vector<fs::path> objects;
+    std::vector<std::string> containers;
+    fs::path objects_dir = root_data / game->path("data") / "objects";
+    boost::system::error_code ec;
+    for( fs::directory_iterator it(objects_dir, ec), end; it != end; it.increment(ec) )
+    {
+        std::ifstream in(it->path().c_str());
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        size_t pos = content.find(version_template);
+        if( pos != std::string::npos )
+            content.replace(pos, version_template.size(), CONFIG_TD_VERSION);
+
+        pugi::xml_document doc;
+        if( ! doc.load(content.c_str()) || ! doc.child(CONFIG_TD_NAME).first_child() )
+            continue;
+
+        fs::path object = fs::temp_directory_path() / ("td_bench_" + it->path().filename().string());
+        std::ofstream out(object.c_str());
+        out << content;
+        objects.push_back(object);
+        containers.push_back(doc.child(CONFIG_TD_NAME).first_child().name());
+    }
+    log_notice("  %s: %lu object definitions in \"%s\"", bench.name(), static_cast<unsigned long>(objects.size()), objects_dir.c_str());
+
+    unsigned long config_time = 0, user_time = 0, objects_time = 0, start;
+    for( uint i = 0; i < loads; i++ )
+    {
+        start = bench.now();
+        {
+            CData data("Game");
+            data.loadData(global_config.c_str());
+            if( fs::exists(user_config) )
+                data.loadData(user_config.c_str());
+        }
+        config_time += bench.now() - start;
+
+        start = bench.now();
+        {
+            CData data("User");
+            data.loadData(user_skeleton.c_str());
+        }
+        user_time += bench.now() - start;
+
+        start = bench.now();
+        for( size_t o = 0; o < objects.size(); o++ )
+        {
+            CData data(containers[o].c_str());
+            data.loadData(objects[o].c_str());
+        }
+        objects_time += bench.now() - start;
+    }
+
+    bench.result("global and user config", static_cast<double>(config_time) / loads, "usec");
+    bench.result("user skeleton", static_cast<double>(user_time) / loads, "usec");
+    bench.result("object definitions", static_cast<double>(objects_time) / loads, "usec");
+
+    for( std::vector<fs::path>::iterator it = objects.begin(); it != objects.end(); ++it )
+        fs::remove(*it, ec);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file    DebugDraw.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Debug drawer geometry submission benchmarks
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CGame.h"
+#include "CThreadPool.h"
+#include "OgreDebugDrawer/DebugDrawer.h"
+
+#include <cstdio>
+
+TD_BENCHMARK(debug_draw, "Debug drawer submit, merge and build of 100k primitives into hardware buffers")
+{
+    const uint primitives = 100000;
+    const uint frames = 20;
+
+    // Headless game has software hardware buffers, copy to them is measured without GPU
+    DebugDrawer drawer(CGame::getInstance()->m_pSceneMgr, 0.5f);
+
+    Ogre::AxisAlignedBox box(Ogre::Vector3(-1.0f, -1.0f, -1.0f), Ogre::Vector3(1.0f, 1.0f, 1.0f));
+    const Ogre::Vector3* corners = box.getAllCorners();
+
+    char label[64];
+    for( uint kind = 0; kind < 3; kind++ )
+    {
+        static const char* names[] = { "lines", "cuboids", "filled cuboids" };
+        unsigned long submit_time = 0, build_time = 0, start;
+        for( uint f = 0; f < frames; f++ )
+        {
+            start = bench.now();
+            drawer.clear();
+            for( uint i = 0; i < primitives; i++ )
+            {
+                Ogre::Vector3 pos(static_cast<Ogre::Real>(i % 100), static_cast<Ogre::Real>(i / 100 % 100), static_cast<Ogre::Real>(i / 10000));
+                if( kind == 0 )
+                    drawer.drawLine(pos, pos + Ogre::Vector3::UNIT_Y, Ogre::ColourValue::Green);
+                else
+                    drawer.drawCuboid(corners, Ogre::ColourValue::Red, kind == 2);
+            }
+            submit_time += bench.now() - start;
+
+            start = bench.now();
+            drawer.merge();
+            drawer.build();
+            build_time += bench.now() - start;
+        }
+
+        std::snprintf(label, sizeof(label), "%u %s submit", primitives, names[kind]);
+        bench.result(label, static_cast<double>(submit_time) / frames, "usec/frame");
+        std::snprintf(label, sizeof(label), "%u %s build", primitives, names[kind]);
+        bench.result(label, static_cast<double>(build_time) / frames, "usec/frame");
+    }
+
+    // Every pool thread draws into own geometry, merged by caller
+    CThreadPool pool(CThreadPool::hardwareThreads() - 1);
+    const uint batch = 1000;
+    unsigned long submit_time = 0, merge_time = 0, start;
+    for( uint f = 0; f < frames; f++ )
+    {
+        start = bench.now();
+        drawer.clear();
+        pool.parallel(primitives / batch, [&drawer, batch](uint b) {
+            for( uint i = b * batch; i < (b + 1) * batch; i++ )
+            {
+                Ogre::Vector3 pos(static_cast<Ogre::Real>(i % 100), static_cast<Ogre::Real>(i / 100 % 100), static_cast<Ogre::Real>(i / 10000));
+                drawer.drawLine(pos, pos + Ogre::Vector3::UNIT_Y, Ogre::ColourValue::Green);
+            }
+        });
+        submit_time += bench.now() - start;
+
+        start = bench.now();
+        drawer.merge();
+        merge_time += bench.now() - start;
+        drawer.build();
+    }
+
+    std::snprintf(label, sizeof(label), "%u lines pool submit", primitives);
+    bench.result(label, static_cast<double>(submit_time) / frames, "usec/frame");
+    std::snprintf(label, sizeof(label), "%u lines pool merge", primitives);
+    bench.result(label, static_cast<double>(merge_time) / frames, "usec/frame");
+}
+
+TD_BENCHMARK(ico_sphere, "Debug sphere mesh creation and draw of 1k spheres at recursion levels 1-5")
+{
+    const uint spheres = 1000;
+    const uint frames = 10;
+
+    DebugGeometry geometry(Ogre::VertexElement::getBestColourVertexElementType());
+
+    char label[64];
+    for( int level = 1; level <= 5; level++ )
+    {
+        unsigned long start = bench.now();
+        IcoSphere sphere(level);
+        std::snprintf(label, sizeof(label), "level %d create", level);
+        bench.result(label, static_cast<double>(bench.now() - start), "usec");
+
+        unsigned long time = 0;
+        for( uint f = 0; f < frames; f++ )
+        {
+            geometry.clear();
+            start = bench.now();
+            for( uint i = 0; i < spheres; i++ )
+            {
+                Ogre::Vector3 pos(static_cast<Ogre::Real>(i % 10), static_cast<Ogre::Real>(i / 10 % 10), static_cast<Ogre::Real>(i / 100));
+                geometry.buildSphere(sphere, pos, 0.5f, Ogre::ColourValue::Blue);
+                geometry.buildFilledSphere(sphere, pos, 0.5f, Ogre::ColourValue::Blue, 0.5f);
+            }
+            time += bench.now() - start;
+        }
+
+        std::snprintf(label, sizeof(label), "level %d draw %u spheres", level, spheres);
+        bench.result(label, static_cast<double>(time) / frames, "usec/frame");
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file    GravityField.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Gravity field benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CGame.h"
+
+#include <cmath>
+#include <cstdio>
+
+TD_BENCHMARK(gravity_field, "Gravity field detection cost vs number of cubes")
+{
+    static const uint counts[] = { 10, 50, 100, 250, 500, 1000 };
+    const uint ticks = 300;
+    const Ogre::Real tick = 1.0f / 120.0f;
+
+    for( uint c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ )
+    {
+        CWorld* world = new CWorld();
+
+        // Grid of cubes, one kernel falling on every tenth cube
+        uint side = static_cast<uint>(std::ceil(std::pow(static_cast<double>(counts[c]), 1.0 / 3.0)));
+        for( uint i = 0; i < counts[c]; i++ )
+        {
+            Ogre::Vector3 pos(static_cast<Ogre::Real>(i % side) * 100.0f,
+                              static_cast<Ogre::Real>((i / side) % side) * 100.0f,
+                              static_cast<Ogre::Real>(i / (side * side)) * 100.0f);
+            world->attachChild(new CObjectCube(*world, CObjectCube::ACUBE, pos));
+            if( i % 10 == 0 )
+                world->attachChild(new CObjectKernel(*world, 20, pos + Ogre::Vector3(0.0f, 15.0f, 0.0f)));
+        }
+
+        // Settle contacts
+        for( uint i = 0; i < 10; i++ )
+            world->update(tick);
+
+        unsigned long field_time = 0, tick_time = 0, start;
+        for( uint i = 0; i < ticks; i++ )
+        {
+            start = bench.now();
+            world->update(tick);
+            tick_time += bench.now() - start;
+
+            start = bench.now();
+            world->m_pGravityField->catchFieldContact();
+            world->m_pGravityField->clearObjectsInGravityField();
+            field_time += bench.now() - start;
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "cubes %u field", counts[c]);
+        bench.result(label, static_cast<double>(field_time) / ticks, "usec/tick");
+        std::snprintf(label, sizeof(label), "cubes %u tick", counts[c]);
+        bench.result(label, static_cast<double>(tick_time) / ticks, "usec/tick");
+
+        delete world;
+    }
+}
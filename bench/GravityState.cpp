@@ -0,0 +1,75 @@
+/**
+ * @file    GravityState.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Objects gravity state storage benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CGravityField.h"
+
+TD_BENCHMARK(gravity_state, "Per-object gravity state: std::map by uid vs slot map, 10k objects")
+{
+    const uint objects = 10000;
+    const uint frames = 200;
+    const btVector3 force(0.0f, -1.0f, 0.0f);
+    btScalar sum = 0.0f;
+    unsigned long start;
+
+    // Previous storage: tree maps keyed by broadphase uid, cleared every frame
+    {
+        std::map<int, bool> in_field;
+        std::map<int, btVector3> gravity;
+        for( uint i = 0; i < objects; i++ )
+            gravity[static_cast<int>(i)] = btVector3(0.0f, 0.0f, 0.0f);
+
+        start = bench.now();
+        for( uint f = 0; f < frames; f++ )
+        {
+            for( uint i = 0; i < objects; i++ )
+            {
+                int uid = static_cast<int>(i);
+                in_field[uid] = true;
+                gravity[uid] = gravity[uid] + force;
+            }
+            for( uint i = 0; i < objects; i++ )
+            {
+                btVector3 temp = gravity[static_cast<int>(i)];
+                gravity[static_cast<int>(i)].setZero();
+                sum += temp.y();
+            }
+            in_field.clear();
+        }
+        bench.result("std::map", static_cast<double>(bench.now() - start) / frames, "usec/frame");
+    }
+
+    // Slot map in gravity field
+    {
+        CGravityField field(NULL, 20.0f);
+        std::vector<CGravityField::Handle> handles;
+        for( uint i = 0; i < objects; i++ )
+            handles.push_back(field.addObject());
+
+        start = bench.now();
+        for( uint f = 0; f < frames; f++ )
+        {
+            for( uint i = 0; i < objects; i++ )
+                field.setObjectGravity(handles[i], &force);
+            for( uint i = 0; i < objects; i++ )
+                sum += field.getObjectGravity(handles[i]).y();
+            field.clearObjectsInGravityField();
+        }
+        bench.result("slot map", static_cast<double>(bench.now() - start) / frames, "usec/frame");
+    }
+
+    // Keep results alive
+    if( sum == 0.0f )
+        log_debug("Gravity state benchmark checksum is zero");
+}
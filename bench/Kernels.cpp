@@ -0,0 +1,64 @@
+/**
+ * @file    Kernels.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Kernel system update benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CGame.h"
+
+#include <cstdio>
+
+TD_BENCHMARK(kernels, "Kernel system update of moving kernels: caller thread vs thread pool batches")
+{
+    static const uint counts[] = { 1000, 10000 };
+    const uint ticks = 300;
+    const Ogre::Real tick = 1.0f / 120.0f;
+    const Ogre::Vector3 front(0.0f, -1.0f, 1.0f);
+
+    CThreadPool pool(CThreadPool::hardwareThreads() - 1);
+
+    char label[64];
+    for( uint c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ )
+    {
+        CWorld* world = new CWorld();
+
+        // Kernels above one cube, all of them are moving forward
+        world->spawn<CObjectCube>(CObjectCube::ZCUBE, Ogre::Vector3(0.0f, 0.0f, 0.0f));
+        for( uint i = 0; i < counts[c]; i++ )
+        {
+            CObjectKernel* kernel = world->spawn<CObjectKernel>(20, Ogre::Vector3(static_cast<Ogre::Real>(i % 100) * 5.0f - 250.0f, 600.0f,
+                                                                                  static_cast<Ogre::Real>(i / 100) * 5.0f - 250.0f));
+            CSignal signal(0, 1.0f);
+            kernel->doAction('f', signal);
+        }
+
+        // Settle contacts with gravity field
+        for( uint i = 0; i < 10; i++ )
+            world->update(tick);
+
+        for( uint threaded = 0; threaded < 2; threaded++ )
+        {
+            unsigned long time = 0, start;
+            for( uint i = 0; i < ticks; i++ )
+            {
+                start = bench.now();
+                world->m_pKernels->update(tick, front, threaded ? &pool : NULL);
+                time += bench.now() - start;
+            }
+
+            std::snprintf(label, sizeof(label), "kernels %u %s", counts[c], threaded ? "pool" : "caller");
+            bench.result(label, static_cast<double>(time) / ticks, "usec/tick");
+        }
+
+        delete world;
+    }
+}
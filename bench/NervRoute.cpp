@@ -0,0 +1,132 @@
+/**
+ * @file    NervRoute.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Nerv signal routing benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "Nerv/CControlled.h"
+#include "Nerv/CSynaps.h"
+#include "Nerv/CNervTable.h"
+
+#include <OIS/OIS.h>
+
+/** @brief Controlled object counting actions
+ */
+class CBenchControlled
+    : public CControlled
+{
+public:
+    CBenchControlled() : CControlled("Bench"), m_Count(0), m_Sum(0.0f) { registerActions(); }
+
+    void doAction(char, CSignal& sig) { m_Count++; m_Sum += sig.value(); }
+
+    unsigned long m_Count; ///< Received actions
+    float         m_Sum;   ///< Sum of values
+
+protected:
+    void registerActions() { addAction('a', "Act"); }
+};
+
+TD_BENCHMARK(nerv_route, "Routing of 1M synthetic input signals: maps vs compiled table")
+{
+    const uint events = 1000000;
+    const uint mapped = 64;
+
+    CBenchControlled obj;
+    CAction* act = obj.getAction("Act");
+
+    // Signal ids of keyboard keys, mouse moves and buttons, joystick axes
+    std::vector<uint> ids;
+    for( uint i = 0; i < 128; i++ )
+        ids.push_back(10000u + i);
+    for( uint i = 0; i < 6; i++ )
+        ids.push_back(20000u + i);
+    for( uint i = 0; i < 8; i++ )
+        ids.push_back(21000u + i);
+    for( uint i = 0; i < 16; i++ )
+        ids.push_back(32000u + i);
+
+    std::vector<CSynaps*> synapses;
+    for( uint i = 0; i < mapped; i++ )
+        synapses.push_back(new CSynaps(ids[(i * 7) % ids.size()], act, 1.0f));
+
+    // Synthetic events stream
+    std::vector<uint> stream;
+    uint seed = 12345;
+    for( uint i = 0; i < events; i++ )
+    {
+        seed = seed * 1103515245u + 12345u;
+        stream.push_back(ids[(seed >> 8) % ids.size()]);
+    }
+
+    // Previous routing: device map of signal maps, nerv maps by string name, multimap of synapses
+    {
+        std::map<OIS::Type, std::map<uint, int> > subscribed;
+        std::map<std::string, std::multimap<uint, CSynaps*> > nerv_maps;
+        std::string current = "default";
+        for( uint i = 0; i < mapped; i++ )
+        {
+            subscribed[static_cast<OIS::Type>(synapses[i]->id() / 10000u)][synapses[i]->id()] = 1;
+            nerv_maps[current].insert(std::make_pair(synapses[i]->id(), synapses[i]));
+        }
+
+        obj.m_Count = 0;
+        unsigned long start = bench.now();
+        for( uint i = 0; i < events; i++ )
+        {
+            CSignal sig(stream[i], static_cast<float>(i & 1));
+            std::map<uint, int>& users = subscribed[static_cast<OIS::Type>(stream[i] / 10000u)];
+            if( users.find(sig.id()) == users.end() )
+                continue;
+
+            std::pair<std::multimap<uint, CSynaps*>::iterator, std::multimap<uint, CSynaps*>::iterator> itp
+                = nerv_maps[current.c_str()].equal_range(sig.id());
+            for( std::multimap<uint, CSynaps*>::iterator it = itp.first; it != itp.second; ++it )
+                it->second->route(sig);
+        }
+        bench.result("maps", static_cast<double>(bench.now() - start) * 1000.0 / events, "nsec/signal");
+        bench.result("maps actions", static_cast<double>(obj.m_Count), "actions");
+    }
+
+    // Compiled tables: sensor subscribers and user route
+    {
+        CNervTable<int> subscribed;
+        CNervTable<CSynaps*> route;
+        for( uint i = 0; i < mapped; i++ )
+        {
+            subscribed.remove(synapses[i]->id());
+            subscribed.add(synapses[i]->id(), 1);
+            route.add(synapses[i]->id(), synapses[i]);
+        }
+        subscribed.build();
+        route.build();
+
+        obj.m_Count = 0;
+        unsigned long start = bench.now();
+        uint count;
+        for( uint i = 0; i < events; i++ )
+        {
+            CSignal sig(stream[i], static_cast<float>(i & 1));
+            if( subscribed.find(sig.id(), count) == NULL )
+                continue;
+
+            CSynaps** synaps = route.find(sig.id(), count);
+            for( uint j = 0; j < count; j++ )
+                synaps[j]->route(sig);
+        }
+        bench.result("table", static_cast<double>(bench.now() - start) * 1000.0 / events, "nsec/signal");
+        bench.result("table actions", static_cast<double>(obj.m_Count), "actions");
+    }
+
+    for( std::vector<CSynaps*>::iterator it = synapses.begin(); it != synapses.end(); it++ )
+        delete *it;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file    ObjectPool.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   World objects spawn and despawn benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CGame.h"
+
+#include <cstdio>
+
+TD_BENCHMARK(object_pool, "Despawn and respawn of cubes and kernels: heap objects vs world pools")
+{
+    static const uint counts[] = { 100, 1000 };
+    const uint rounds = 10;
+
+    char label[64];
+    for( uint c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ )
+    {
+        for( uint pooled = 0; pooled < 2; pooled++ )
+        {
+            CWorld* world = new CWorld();
+            unsigned long spawn_time = 0, despawn_time = 0, start;
+            for( uint r = 0; r < rounds; r++ )
+            {
+                start = bench.now();
+                for( uint i = 0; i < counts[c]; i++ )
+                {
+                    Ogre::Vector3 pos(static_cast<Ogre::Real>(i) * 100.0f, 0.0f, 0.0f);
+                    if( pooled )
+                    {
+                        world->spawn<CObjectCube>(CObjectCube::ACUBE, pos);
+                        world->spawn<CObjectKernel>(20, pos + Ogre::Vector3(0.0f, 15.0f, 0.0f));
+                    }
+                    else
+                    {
+                        world->attachChild(new CObjectCube(*world, CObjectCube::ACUBE, pos));
+                        world->attachChild(new CObjectKernel(*world, 20, pos + Ogre::Vector3(0.0f, 15.0f, 0.0f)));
+                    }
+                }
+                spawn_time += bench.now() - start;
+
+                // Objects are despawned in spawn order - last object fills every hole
+                start = bench.now();
+                while( ! world->getChildrens()->empty() )
+                    world->despawn(world->getChildrens()->front());
+                despawn_time += bench.now() - start;
+            }
+
+            std::snprintf(label, sizeof(label), "objects %u %s spawn", counts[c] * 2, pooled ? "pool" : "heap");
+            bench.result(label, static_cast<double>(spawn_time) / (rounds * counts[c] * 2), "usec/object");
+            std::snprintf(label, sizeof(label), "objects %u %s despawn", counts[c] * 2, pooled ? "pool" : "heap");
+            bench.result(label, static_cast<double>(despawn_time) / (rounds * counts[c] * 2), "usec/object");
+
+            delete world;
+        }
+    }
+}
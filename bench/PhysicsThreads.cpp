@@ -0,0 +1,84 @@
+/**
+ * @file    PhysicsThreads.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Multithreaded physics scaling benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CThreadPool.h"
+#include "CGame.h"
+
+#include <cstdio>
+
+/** @brief Step time of world with kernels dropped on cubes
+ *
+ * @param bench
+ * @param kernels - Number of kernels
+ * @return double - Microseconds per tick
+ */
+static double stepKernels(CBenchmark& bench, uint kernels)
+{
+    const uint ticks = 240;
+    const Ogre::Real tick = 1.0f / 120.0f;
+
+    CWorld* world = new CWorld();
+    for( uint i = 0; i < kernels; i++ )
+    {
+        // Cube for every 4 kernels
+        Ogre::Vector3 pos(static_cast<Ogre::Real>((i / 4) % 20) * 100.0f, 0.0f, static_cast<Ogre::Real>((i / 4) / 20) * 100.0f);
+        if( i % 4 == 0 )
+            world->attachChild(new CObjectCube(*world, CObjectCube::ACUBE, pos));
+        world->attachChild(new CObjectKernel(*world, 20, pos + Ogre::Vector3(static_cast<Ogre::Real>(i % 2) * 3.0f,
+                                                                             15.0f + static_cast<Ogre::Real>(i % 4) * 5.0f,
+                                                                             static_cast<Ogre::Real>((i / 2) % 2) * 3.0f)));
+    }
+
+    unsigned long start = bench.now();
+    for( uint i = 0; i < ticks; i++ )
+        world->update(tick);
+    double result = static_cast<double>(bench.now() - start) / ticks;
+
+    delete world;
+
+    return result;
+}
+
+TD_BENCHMARK(physics_threads, "Physics step time of N kernels dropped onto cubes vs physics threads")
+{
+    static const uint counts[] = { 100, 400, 1600 };
+    CGame* game = CGame::getInstance();
+    uint threads = game->physicsThreads();
+    char label[64];
+
+    if( threads == 0 )
+        log_warn("Multithreaded physics is disabled (config physics/world), measuring single threaded world");
+
+    for( uint c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ )
+    {
+        if( threads == 0 )
+        {
+            std::snprintf(label, sizeof(label), "kernels %u single", counts[c]);
+            bench.result(label, stepKernels(bench, counts[c]), "usec/tick");
+            continue;
+        }
+
+        for( uint t = 1; t <= CThreadPool::hardwareThreads(); t *= 2 )
+        {
+            game->physicsThreads(t);
+            std::snprintf(label, sizeof(label), "kernels %u threads %u", counts[c], game->physicsThreads());
+            bench.result(label, stepKernels(bench, counts[c]), "usec/tick");
+        }
+    }
+
+    // Back to configured number of threads
+    if( threads > 0 )
+        game->physicsThreads(threads);
+}
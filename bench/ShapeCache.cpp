@@ -0,0 +1,81 @@
+/**
+ * @file    ShapeCache.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Collision shapes creation benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CGame.h"
+#include "World/CShapeCache.h"
+
+#include <cstdio>
+
+TD_BENCHMARK(shape_cache, "Collision shapes of spawned cubes: mesh read back for every cube vs shared shapes cache")
+{
+    static const uint counts[] = { 100, 500 };
+    const char* mesh = "objectcube.mesh";
+    const btVector3 scale(CObjectCube::ACUBE, CObjectCube::ACUBE, CObjectCube::ACUBE);
+    const uint loads = 20;
+
+    char label[64];
+    unsigned long start;
+    for( uint c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ )
+    {
+        // Every cube reads back mesh buffers
+        start = bench.now();
+        for( uint i = 0; i < counts[c]; i++ )
+        {
+            BtOgre::StaticMeshToShapeConverter converter;
+            converter.addMesh(Ogre::MeshManager::getSingleton().load(mesh, Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME));
+            btCollisionShape* shape = converter.createBox();
+            shape->setLocalScaling(scale);
+            delete shape;
+        }
+        std::snprintf(label, sizeof(label), "cubes %u converter", counts[c]);
+        bench.result(label, static_cast<double>(bench.now() - start), "usec");
+
+        // Cubes share one shape
+        start = bench.now();
+        {
+            CShapeCache cache("");
+            for( uint i = 0; i < counts[c]; i++ )
+                cache.shape(mesh, CShapeCache::SHAPE_BOX, scale);
+        }
+        std::snprintf(label, sizeof(label), "cubes %u cache", counts[c]);
+        bench.result(label, static_cast<double>(bench.now() - start), "usec");
+    }
+
+    // Trimesh BVH is built from read back vertices or restored from disk
+    fs::path path = fs::temp_directory_path() / "td_bench_shapes";
+    unsigned long build_time = 0, restore_time = 0;
+    for( uint i = 0; i < loads; i++ )
+    {
+        fs::remove_all(path);
+
+        start = bench.now();
+        {
+            CShapeCache cache(path.c_str());
+            cache.shape(mesh, CShapeCache::SHAPE_TRIMESH);
+        }
+        build_time += bench.now() - start;
+
+        start = bench.now();
+        {
+            CShapeCache cache(path.c_str());
+            cache.shape(mesh, CShapeCache::SHAPE_TRIMESH);
+        }
+        restore_time += bench.now() - start;
+    }
+    bench.result("trimesh build and save", static_cast<double>(build_time) / loads, "usec");
+    bench.result("trimesh restore", static_cast<double>(restore_time) / loads, "usec");
+
+    fs::remove_all(path);
+}
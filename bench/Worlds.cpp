@@ -0,0 +1,67 @@
+/**
+ * @file    Worlds.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Parallel worlds update benchmark
+ *
+ *
+ */
+
+#include "CBenchmark.h"
+#include "CThreadPool.h"
+#include "CGame.h"
+
+#include <cstdio>
+
+TD_BENCHMARK(worlds, "Tick time of 8 independent worlds vs number of threads")
+{
+    const uint count = 8;
+    const uint ticks = 300;
+    const Ogre::Real tick = 1.0f / 120.0f;
+
+    // Every world is an arena: row of cubes with kernel above each
+    std::vector<CWorld*> worlds;
+    for( uint w = 0; w < count; w++ )
+    {
+        CWorld* world = new CWorld();
+        for( uint i = 0; i < 50; i++ )
+        {
+            Ogre::Vector3 pos(static_cast<Ogre::Real>(i) * 100.0f, 0.0f, 0.0f);
+            world->attachChild(new CObjectCube(*world, CObjectCube::ACUBE, pos));
+            world->attachChild(new CObjectKernel(*world, 20, pos + Ogre::Vector3(0.0f, 15.0f, 0.0f)));
+        }
+        worlds.push_back(world);
+    }
+
+#ifdef CONFIG_BULLET_PARALLEL_WORLDS
+    const uint max_threads = CThreadPool::hardwareThreads();
+#else
+    // Old bullet steps write to one global profiler
+    const uint max_threads = 1;
+#endif
+
+    for( uint threads = 1; threads <= max_threads; threads *= 2 )
+    {
+        CThreadPool pool(threads - 1);
+
+        unsigned long start = bench.now();
+        for( uint i = 0; i < ticks; i++ )
+        {
+            pool.parallel(count, [&worlds, tick](uint w) {
+                worlds[w]->update(tick);
+            });
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "threads %u", threads);
+        bench.result(label, static_cast<double>(bench.now() - start) / ticks, "usec/tick");
+    }
+
+    for( std::vector<CWorld*>::iterator it = worlds.begin(); it != worlds.end(); it++ )
+        delete *it;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file    main.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Benchmarks entry point
+ *
+ * Usage: td_bench [name|all|list] [--json <file>] [game arguments]
+ */
+
+#include "CGame.h"
+#include "CBenchmark.h"
+
+#include <cstring>
+
+/** @brief Run benchmark scenarios in headless game
+ *
+ * @param argc
+ * @param argv
+ * @return int - 0 if scenarios was found and results written
+ */
+int main(int argc, char** argv)
+{
+    // Scenario name goes first, other arguments are game arguments
+    const char* name = "all";
+    std::vector<char*> args(argv, argv + argc);
+    if( argc > 1 && std::strncmp(argv[1], "--", 2) != 0 )
+    {
+        name = argv[1];
+        args.erase(args.begin() + 1);
+    }
+    char headless[] = "--headless";
+    args.insert(args.begin() + 1, headless);
+
+    bool ok = false;
+    try {
+        CGame* game = CGame::getInstance();
+        game->loadArgs(static_cast<int>(args.size()), &args[0]);
+        if( game->initialise() )
+        {
+            ok = CBenchmark::run(name);
+            if( ok && *game->arg("json") )
+                ok = CBenchmark::writeJson(game->arg("json"));
+        }
+    }
+    catch( Common::Exception const& e ) {
+        log_emerg("An Common exception has occured: %s", e.getFullDescription().c_str());
+    }
+    catch( Ogre::Exception const& e ) {
+        log_emerg("An Ogre exception has occured: %s", e.getFullDescription().c_str());
+    }
+    catch( std::exception const& e ) {
+        log_emerg("An standart exception has occured: %s", e.what());
+    }
+    catch(...) {
+        log_emerg("An unknown exception has occured!");
+    }
+
+    CGame::destroyInstance();
+
+    // Write all queued messages
+    Common::CLog::stop();
+
+    return ok ? 0 : 1;
+}
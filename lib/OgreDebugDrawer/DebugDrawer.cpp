@@ -11,29 +11,30 @@
 #include <OGRE/OgreRenderQueue.h>
 #include <OGRE/OgreManualObject.h>
 #include <OGRE/OgreAxisAlignedBox.h>
+#include <OGRE/OgreHardwareBufferManager.h>
+#include <OGRE/OgreRoot.h>
 
-IcoSphere::IcoSphere()
+#include <algorithm>
+#include <unordered_set>
+
+IcoSphere::IcoSphere(int recursionLevel)
     : vertices()
     , lineIndices()
     , triangleIndices()
-    , faces()
-    , middlePointIndexCache()
-    , index(0)
-{
-}
-
-IcoSphere::~IcoSphere()
 {
-}
+    static const Ogre::uint32 icosahedron[] = {
+        0, 11, 5,    0, 5, 1,     0, 1, 7,     0, 7, 10,    0, 10, 11,
+        1, 5, 9,     5, 11, 4,    11, 10, 2,   10, 7, 6,    7, 1, 8,
+        3, 9, 4,     3, 4, 2,     3, 2, 6,     3, 6, 8,     3, 8, 9,
+        4, 9, 5,     2, 4, 11,    6, 2, 10,    8, 6, 7,     9, 8, 1
+    };
 
-void IcoSphere::create(int recursionLevel)
-{
-    vertices.clear();
-    lineIndices.clear();
-    triangleIndices.clear();
-    faces.clear();
-    middlePointIndexCache.clear();
-    index = 0;
+    // Every level splits face into 4, sizes are known
+    size_t scale = 1;
+    for (int i = 0; i < recursionLevel; i++) scale *= 4;
+    vertices.reserve(10 * scale + 2);
+    triangleIndices.reserve(60 * scale);
+    lineIndices.reserve(60 * scale);
 
     float t = (1.0f + Ogre::Math::Sqrt(5.0f)) / 2.0f;
 
@@ -52,177 +53,204 @@ void IcoSphere::create(int recursionLevel)
     addVertex(Ogre::Vector3(-t,  0.0f, -1.0f));
     addVertex(Ogre::Vector3(-t,  0.0f,  1.0f));
 
-    addFace(0, 11, 5);
-    addFace(0, 5, 1);
-    addFace(0, 1, 7);
-    addFace(0, 7, 10);
-    addFace(0, 10, 11);
-
-    addFace(1, 5, 9);
-    addFace(5, 11, 4);
-    addFace(11, 10, 2);
-    addFace(10, 7, 6);
-    addFace(7, 1, 8);
-
-    addFace(3, 9, 4);
-    addFace(3, 4, 2);
-    addFace(3, 2, 6);
-    addFace(3, 6, 8);
-    addFace(3, 8, 9);
-
-    addFace(4, 9, 5);
-    addFace(2, 4, 11);
-    addFace(6, 2, 10);
-    addFace(8, 6, 7);
-    addFace(9, 8, 1);
-
-    addLineIndices(1, 0);
-    addLineIndices(1, 5);
-    addLineIndices(1, 7);
-    addLineIndices(1, 8);
-    addLineIndices(1, 9);
-
-    addLineIndices(2, 3);
-    addLineIndices(2, 4);
-    addLineIndices(2, 6);
-    addLineIndices(2, 10);
-    addLineIndices(2, 11);
-
-    addLineIndices(0, 5);
-    addLineIndices(5, 9);
-    addLineIndices(9, 8);
-    addLineIndices(8, 7);
-    addLineIndices(7, 0);
-
-    addLineIndices(10, 11);
-    addLineIndices(11, 4);
-    addLineIndices(4, 3);
-    addLineIndices(3, 6);
-    addLineIndices(6, 10);
-
-    addLineIndices(0, 11);
-    addLineIndices(11, 5);
-    addLineIndices(5, 4);
-    addLineIndices(4, 9);
-    addLineIndices(9, 3);
-    addLineIndices(3, 8);
-    addLineIndices(8, 6);
-    addLineIndices(6, 7);
-    addLineIndices(7, 10);
-    addLineIndices(10, 0);
+    triangleIndices.assign(icosahedron, icosahedron + sizeof(icosahedron) / sizeof(icosahedron[0]));
 
+    EdgeCache middlePoints;
+    middlePoints.reserve(30 * scale);
+    std::vector<Ogre::uint32> faces;
     for (int i = 0; i < recursionLevel; i++)
     {
-        std::list<TriangleIndices> faces2;
+        faces.clear();
+        faces.reserve(triangleIndices.size() * 4);
 
-        for (std::list<TriangleIndices>::iterator j = faces.begin(); j != faces.end(); j++)
+        for (size_t j = 0; j < triangleIndices.size(); j += 3)
         {
-            TriangleIndices f = *j;
-            uint a = getMiddlePoint(f.v1, f.v2);
-            uint b = getMiddlePoint(f.v2, f.v3);
-            uint c = getMiddlePoint(f.v3, f.v1);
-
-            removeLineIndices(f.v1, f.v2);
-            removeLineIndices(f.v2, f.v3);
-            removeLineIndices(f.v3, f.v1);
-
-            faces2.push_back(TriangleIndices(f.v1, a, c));
-            faces2.push_back(TriangleIndices(f.v2, b, a));
-            faces2.push_back(TriangleIndices(f.v3, c, b));
-            faces2.push_back(TriangleIndices(a, b, c));
-
-            addTriangleLines(f.v1, a, c);
-            addTriangleLines(f.v2, b, a);
-            addTriangleLines(f.v3, c, b);
+            uint v1 = triangleIndices[j], v2 = triangleIndices[j + 1], v3 = triangleIndices[j + 2];
+            uint a = getMiddlePoint(v1, v2, middlePoints);
+            uint b = getMiddlePoint(v2, v3, middlePoints);
+            uint c = getMiddlePoint(v3, v1, middlePoints);
+
+            const Ogre::uint32 split[] = { v1, a, c,   v2, b, a,   v3, c, b,   a, b, c };
+            faces.insert(faces.end(), split, split + 12);
         }
 
-        faces = faces2;
+        triangleIndices.swap(faces);
     }
-}
 
-void IcoSphere::addLineIndices(uint index0, uint index1)
-{
-    lineIndices.push_back(LineIndices(index0, index1));
+    // Edge is shared by two faces and drawn once
+    std::unordered_set<uint64_t> edges;
+    edges.reserve(triangleIndices.size());
+    for (size_t j = 0; j < triangleIndices.size(); j += 3)
+    {
+        for (uint k = 0; k < 3; k++)
+        {
+            uint index0 = triangleIndices[j + k], index1 = triangleIndices[j + (k + 1) % 3];
+            if (edges.insert(edgeKey(index0, index1)).second)
+            {
+                lineIndices.push_back(index0);
+                lineIndices.push_back(index1);
+            }
+        }
+    }
 }
 
-void IcoSphere::removeLineIndices(uint index0, uint index1)
+const IcoSphere &IcoSphere::get(int recursionLevel)
 {
-    std::list<LineIndices>::iterator result = std::find(lineIndices.begin(), lineIndices.end(), LineIndices(index0, index1));
+    static std::mutex mutex;
+    static std::map<int, IcoSphere> spheres;
 
-    if (result != lineIndices.end())
-        lineIndices.erase(result);
+    if (recursionLevel < 0) recursionLevel = 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<int, IcoSphere>::iterator i = spheres.find(recursionLevel);
+    if (i == spheres.end())
+        i = spheres.insert(std::make_pair(recursionLevel, IcoSphere(recursionLevel))).first;
+    return i->second;
 }
 
-void IcoSphere::addTriangleLines(uint index0, uint index1, uint index2)
+uint64_t IcoSphere::edgeKey(uint index0, uint index1)
 {
-    addLineIndices(index0, index1);
-    addLineIndices(index1, index2);
-    addLineIndices(index2, index0);
+    bool isFirstSmaller = index0 < index1;
+    uint64_t smallerIndex = isFirstSmaller ? index0 : index1;
+    uint64_t largerIndex = isFirstSmaller ? index1 : index0;
+    return (smallerIndex << 32) | largerIndex;
 }
 
 uint IcoSphere::addVertex(const Ogre::Vector3 &vertex)
 {
-    Ogre::Real length = vertex.length();
-    vertices.push_back(Ogre::Vector3(vertex.x / length, vertex.y / length, vertex.z / length));
-    return index++;
+    vertices.push_back(vertex.normalisedCopy());
+    return static_cast<uint>(vertices.size() - 1);
 }
 
-uint IcoSphere::getMiddlePoint(uint index0, uint index1)
+uint IcoSphere::getMiddlePoint(uint index0, uint index1, EdgeCache &middlePoints)
 {
-    bool isFirstSmaller = index0 < index1;
-    uint64_t smallerIndex = isFirstSmaller ? index0 : index1;
-    uint64_t largerIndex = isFirstSmaller ? index1 : index0;
-    uint64_t key = (smallerIndex << 32) | largerIndex;
-
-    if (middlePointIndexCache.find(key) != middlePointIndexCache.end())
-        return middlePointIndexCache[key];
+    uint64_t key = edgeKey(index0, index1);
 
-    Ogre::Vector3 point1 = vertices[index0];
-    Ogre::Vector3 point2 = vertices[index1];
-    Ogre::Vector3 middle = point1.midPoint(point2);
+    EdgeCache::const_iterator i = middlePoints.find(key);
+    if (i != middlePoints.end())
+        return i->second;
 
-    uint index = addVertex(middle);
-    middlePointIndexCache[key] = index;
+    uint index = addVertex(vertices[index0].midPoint(vertices[index1]));
+    middlePoints[key] = index;
     return index;
 }
 
-void IcoSphere::addFace(uint index0, uint index1, uint index2)
+void IcoSphere::addToLineIndices(uint baseIndex, std::vector<Ogre::uint32> *target) const
 {
-    faces.push_back(TriangleIndices(index0, index1, index2));
+    size_t start = target->size();
+    target->resize(start + lineIndices.size());
+
+    Ogre::uint32 *out = &(*target)[start];
+    for (size_t i = 0; i < lineIndices.size(); i++)
+        out[i] = baseIndex + lineIndices[i];
 }
 
-void IcoSphere::addToLineIndices(uint baseIndex, std::list<uint> *target)
+void IcoSphere::addToTriangleIndices(uint baseIndex, std::vector<Ogre::uint32> *target) const
 {
-    for (std::list<LineIndices>::iterator i = lineIndices.begin(); i != lineIndices.end(); i++)
+    size_t start = target->size();
+    target->resize(start + triangleIndices.size());
+
+    Ogre::uint32 *out = &(*target)[start];
+    for (size_t i = 0; i < triangleIndices.size(); i++)
+        out[i] = baseIndex + triangleIndices[i];
+}
+
+uint IcoSphere::addToVertices(std::vector<DebugVertex> *target, const Ogre::Vector3 &position, Ogre::uint32 colour, float scale) const
+{
+    size_t start = target->size();
+    target->resize(start + vertices.size(), DebugVertex(position, colour));
+
+    // Scale and translate only, loop is vectorised by compiler
+    DebugVertex *out = &(*target)[start];
+    for (size_t i = 0; i < vertices.size(); i++)
     {
-        target->push_back(baseIndex + (*i).v1);
-        target->push_back(baseIndex + (*i).v2);
+        out[i].x += vertices[i].x * scale;
+        out[i].y += vertices[i].y * scale;
+        out[i].z += vertices[i].z * scale;
     }
+
+    return static_cast<uint>(vertices.size());
 }
 
-void IcoSphere::addToTriangleIndices(uint baseIndex, std::list<uint> *target)
+DebugRenderable::DebugRenderable(Ogre::RenderOperation::OperationType type)
+    : vertexBuffer()
+    , indexBuffer()
+    , vertexCapacity(0)
+    , indexCapacity(0)
 {
-    for (std::list<TriangleIndices>::iterator i = faces.begin(); i != faces.end(); i++)
+    mRenderOp.operationType = type;
+    mRenderOp.useIndexes = true;
+    mRenderOp.vertexData = new Ogre::VertexData();
+    mRenderOp.vertexData->vertexCount = 0;
+    mRenderOp.indexData = new Ogre::IndexData();
+    mRenderOp.indexData->indexCount = 0;
+
+    // Layout of DebugVertex
+    Ogre::VertexDeclaration *declaration = mRenderOp.vertexData->vertexDeclaration;
+    declaration->addElement(0, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+    declaration->addElement(0, Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3), Ogre::VertexElement::getBestColourVertexElementType(), Ogre::VES_DIFFUSE);
+
+    // Debug geometry is everywhere
+    setBoundingBox(Ogre::AxisAlignedBox::BOX_INFINITE);
+    setVisible(false);
+}
+
+DebugRenderable::~DebugRenderable()
+{
+    delete mRenderOp.vertexData;
+    delete mRenderOp.indexData;
+}
+
+void DebugRenderable::reserve(size_t vertexCount, size_t indexCount)
+{
+    if (vertexCount > vertexCapacity)
+    {
+        vertexCapacity = std::max(vertexCount, std::max(vertexCapacity * 2, static_cast<size_t>(4096)));
+        vertexBuffer = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(sizeof(DebugVertex), vertexCapacity,
+            Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        mRenderOp.vertexData->vertexBufferBinding->setBinding(0, vertexBuffer);
+    }
+
+    if (indexCount > indexCapacity)
     {
-        target->push_back(baseIndex + (*i).v1);
-        target->push_back(baseIndex + (*i).v2);
-        target->push_back(baseIndex + (*i).v3);
+        indexCapacity = std::max(indexCount, std::max(indexCapacity * 2, static_cast<size_t>(8192)));
+        indexBuffer = Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(Ogre::HardwareIndexBuffer::IT_32BIT, indexCapacity,
+            Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        mRenderOp.indexData->indexBuffer = indexBuffer;
     }
 }
 
-uint IcoSphere::addToVertices(std::list<VertexPair> *target, const Ogre::Vector3 &position, const Ogre::ColourValue &colour, float scale)
+void DebugRenderable::update(const std::vector<DebugVertex> &vertices, const std::vector<Ogre::uint32> &indices)
 {
-    Ogre::Matrix4 transform = Ogre::Matrix4::IDENTITY;
-    transform.setTrans(position);
-    transform.setScale(Ogre::Vector3(scale, scale, scale));
+    if (vertices.empty() || indices.empty())
+    {
+        mRenderOp.vertexData->vertexCount = 0;
+        mRenderOp.indexData->indexCount = 0;
+        setVisible(false);
+        return;
+    }
+
+    reserve(vertices.size(), indices.size());
 
-    for (uint i = 0; i < static_cast<uint>(vertices.size()); i++)
-        target->push_back(VertexPair(transform * vertices[i], colour));
+    // One copy of every array, previous contents are discarded
+    vertexBuffer->writeData(0, vertices.size() * sizeof(DebugVertex), &vertices[0], true);
+    indexBuffer->writeData(0, indices.size() * sizeof(Ogre::uint32), &indices[0], true);
 
-    return vertices.size();
+    mRenderOp.vertexData->vertexStart = 0;
+    mRenderOp.vertexData->vertexCount = vertices.size();
+    mRenderOp.indexData->indexStart = 0;
+    mRenderOp.indexData->indexCount = indices.size();
+    setVisible(true);
 }
 
 template<> DebugDrawer* Ogre::Singleton<DebugDrawer>::ms_Singleton = 0;
+
+unsigned long DebugDrawer::nextId = 0;
+
+// Geometry of thread for drawer with id, GCC 4.6 has only POD thread locals
+static __thread DebugGeometry *localGeometry = 0;
+static __thread unsigned long localDrawer = 0;
+
 DebugDrawer* DebugDrawer::getSingletonPtr(void)
 {
     return ms_Singleton;
@@ -236,16 +264,17 @@ DebugDrawer& DebugDrawer::getSingleton(void)
 
 DebugDrawer::DebugDrawer(Ogre::SceneManager *_sceneManager, float _fillAlpha)
    : sceneManager(_sceneManager)
-   , manualObject(0)
+   , sceneNode(0)
+   , lines(0)
+   , triangles(0)
+   , colourType(Ogre::VertexElement::getBestColourVertexElementType())
    , fillAlpha(_fillAlpha)
-   , icoSphere()
+   , icoSphere(0)
    , isEnabled(true)
-   , lineVertices()
-   , triangleVertices()
-   , lineIndices()
-   , triangleIndices()
-   , linesIndex(0)
-   , trianglesIndex(0)
+   , frameGeometry(colourType)
+   , threadGeometries()
+   , threadGeometriesMutex()
+   , id(++nextId)
 {
     initialise();
 }
@@ -253,69 +282,73 @@ DebugDrawer::DebugDrawer(Ogre::SceneManager *_sceneManager, float _fillAlpha)
 DebugDrawer::~DebugDrawer()
 {
     shutdown();
+
+    for (std::vector<DebugGeometry*>::iterator i = threadGeometries.begin(); i != threadGeometries.end(); i++)
+        delete *i;
 }
 
 void DebugDrawer::initialise()
 {
-    manualObject = sceneManager->createManualObject("debug_object");
-    sceneManager->getRootSceneNode()->createChildSceneNode("debug_object")->attachObject(manualObject);
-    manualObject->setDynamic(true);
+    lines = new DebugRenderable(Ogre::RenderOperation::OT_LINE_LIST);
+    triangles = new DebugRenderable(Ogre::RenderOperation::OT_TRIANGLE_LIST);
 
-    icoSphere.create(DEFAULT_ICOSPHERE_RECURSION_LEVEL);
+    // Without render system material can't be loaded and nothing is rendered
+    if (Ogre::Root::getSingleton().getRenderSystem() != 0)
+    {
+        lines->setMaterial("debug_draw");
+        triangles->setMaterial("debug_draw");
+    }
 
-    manualObject->begin("debug_draw", Ogre::RenderOperation::OT_LINE_LIST);
-    manualObject->position(Ogre::Vector3::ZERO);
-    manualObject->colour(Ogre::ColourValue::ZERO);
-    manualObject->index(0);
-    manualObject->end();
-    manualObject->begin("debug_draw", Ogre::RenderOperation::OT_TRIANGLE_LIST);
-    manualObject->position(Ogre::Vector3::ZERO);
-    manualObject->colour(Ogre::ColourValue::ZERO);
-    manualObject->index(0);
-    manualObject->end();
+    sceneNode = sceneManager->getRootSceneNode()->createChildSceneNode("debug_object");
+    sceneNode->attachObject(lines);
+    sceneNode->attachObject(triangles);
 
-    linesIndex = trianglesIndex = 0;
+    icoSphere = &IcoSphere::get(DEFAULT_ICOSPHERE_RECURSION_LEVEL);
 }
 
 void DebugDrawer::setIcoSphereRecursionLevel(int recursionLevel)
 {
-    icoSphere.create(recursionLevel);
+    icoSphere = &IcoSphere::get(recursionLevel);
 }
 
 void DebugDrawer::shutdown()
 {
-    sceneManager->destroySceneNode("debug_object");
-    sceneManager->destroyManualObject(manualObject);
+    sceneNode->detachAllObjects();
+    sceneManager->destroySceneNode(sceneNode);
+    delete lines;
+    delete triangles;
 }
 
-void DebugDrawer::buildLine(const Ogre::Vector3& start, const Ogre::Vector3& end, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildLine(const Ogre::Vector3& start, const Ogre::Vector3& end, const Ogre::ColourValue& colour, float alpha)
 {
-    uint i = addLineVertex(start, Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addLineVertex(end, Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    const Ogre::uint32 packed = packColour(colour, alpha);
+    uint i = addLineVertex(start, packed);
+    addLineVertex(end, packed);
 
     addLineIndices(i, i + 1);
 }
 
-void DebugDrawer::buildQuad(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildQuad(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
 {
-    uint index = addLineVertex(vertices[0], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addLineVertex(vertices[1], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addLineVertex(vertices[2], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addLineVertex(vertices[3], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    const Ogre::uint32 packed = packColour(colour, alpha);
+    uint index = addLineVertex(vertices[0], packed);
+    addLineVertex(vertices[1], packed);
+    addLineVertex(vertices[2], packed);
+    addLineVertex(vertices[3], packed);
 
     for (uint i = 0; i < 4; ++i) addLineIndices(index + i, index + ((i + 1) % 4));
 }
 
-void DebugDrawer::buildCircle(const Ogre::Vector3 &centre, float radius, uint segmentsCount, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildCircle(const Ogre::Vector3 &centre, float radius, uint segmentsCount, const Ogre::ColourValue& colour, float alpha)
 {
+    const Ogre::uint32 packed = packColour(colour, alpha);
     uint index = linesIndex;
     float increment = 2 * Ogre::Math::PI / static_cast<float>(segmentsCount);
     float angle = 0.0f;
 
     for (uint i = 0; i < segmentsCount; i++)
     {
-        addLineVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y, centre.z + radius * Ogre::Math::Sin(angle)),
-            Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+        addLineVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y, centre.z + radius * Ogre::Math::Sin(angle)), packed);
         angle += increment;
     }
 
@@ -323,27 +356,28 @@ void DebugDrawer::buildCircle(const Ogre::Vector3 &centre, float radius, uint se
         addLineIndices(index + i, i + 1 < segmentsCount ? index + i + 1 : index);
 }
 
-void DebugDrawer::buildFilledCircle(const Ogre::Vector3 &centre, float radius, uint segmentsCount, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildFilledCircle(const Ogre::Vector3 &centre, float radius, uint segmentsCount, const Ogre::ColourValue& colour, float alpha)
 {
+    const Ogre::uint32 packed = packColour(colour, alpha);
     uint index = trianglesIndex;
     float increment = 2 * Ogre::Math::PI / static_cast<float>(segmentsCount);
     float angle = 0.0f;
 
     for (uint i = 0; i < segmentsCount; i++)
     {
-        addTriangleVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y, centre.z + radius * Ogre::Math::Sin(angle)),
-            Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+        addTriangleVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y, centre.z + radius * Ogre::Math::Sin(angle)), packed);
         angle += increment;
     }
 
-    addTriangleVertex(centre, Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    addTriangleVertex(centre, packed);
 
     for (uint i = 0; i < segmentsCount; i++)
         addTriangleIndices(i + 1 < segmentsCount ? index + i + 1 : index, index + i, index + segmentsCount);
 }
 
-void DebugDrawer::buildCylinder(const Ogre::Vector3 &centre, float radius, uint segmentsCount, float height, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildCylinder(const Ogre::Vector3 &centre, float radius, uint segmentsCount, float height, const Ogre::ColourValue& colour, float alpha)
 {
+    const Ogre::uint32 packed = packColour(colour, alpha);
     uint index = linesIndex;
     float increment = 2 * Ogre::Math::PI / static_cast<float>(segmentsCount);
     float angle = 0.0f;
@@ -351,8 +385,7 @@ void DebugDrawer::buildCylinder(const Ogre::Vector3 &centre, float radius, uint
     // Top circle
     for (uint i = 0; i < segmentsCount; i++)
     {
-        addLineVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y + height / 2, centre.z + radius * Ogre::Math::Sin(angle)),
-            Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+        addLineVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y + height / 2, centre.z + radius * Ogre::Math::Sin(angle)), packed);
         angle += increment;
     }
 
@@ -361,8 +394,7 @@ void DebugDrawer::buildCylinder(const Ogre::Vector3 &centre, float radius, uint
     // Bottom circle
     for (uint i = 0; i < segmentsCount; i++)
     {
-        addLineVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y - height / 2, centre.z + radius * Ogre::Math::Sin(angle)),
-            Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+        addLineVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y - height / 2, centre.z + radius * Ogre::Math::Sin(angle)), packed);
         angle += increment;
     }
 
@@ -374,8 +406,9 @@ void DebugDrawer::buildCylinder(const Ogre::Vector3 &centre, float radius, uint
     }
 }
 
-void DebugDrawer::buildFilledCylinder(const Ogre::Vector3 &centre, float radius, uint segmentsCount, float height, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildFilledCylinder(const Ogre::Vector3 &centre, float radius, uint segmentsCount, float height, const Ogre::ColourValue& colour, float alpha)
 {
+    const Ogre::uint32 packed = packColour(colour, alpha);
     uint index = trianglesIndex;
     float increment = 2 * Ogre::Math::PI / static_cast<float>(segmentsCount);
     float angle = 0.0f;
@@ -383,24 +416,22 @@ void DebugDrawer::buildFilledCylinder(const Ogre::Vector3 &centre, float radius,
     // Top circle
     for (uint i = 0; i < segmentsCount; i++)
     {
-        addTriangleVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y + height / 2, centre.z + radius * Ogre::Math::Sin(angle)),
-            Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+        addTriangleVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y + height / 2, centre.z + radius * Ogre::Math::Sin(angle)), packed);
         angle += increment;
     }
 
-    addTriangleVertex(Ogre::Vector3(centre.x, centre.y + height / 2, centre.z), Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    addTriangleVertex(Ogre::Vector3(centre.x, centre.y + height / 2, centre.z), packed);
 
     angle = 0.0f;
 
     // Bottom circle
     for (uint i = 0; i < segmentsCount; i++)
     {
-        addTriangleVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y - height / 2, centre.z + radius * Ogre::Math::Sin(angle)),
-            Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+        addTriangleVertex(Ogre::Vector3(centre.x + radius * Ogre::Math::Cos(angle), centre.y - height / 2, centre.z + radius * Ogre::Math::Sin(angle)), packed);
         angle += increment;
     }
 
-    addTriangleVertex(Ogre::Vector3(centre.x, centre.y - height / 2, centre.z), Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    addTriangleVertex(Ogre::Vector3(centre.x, centre.y - height / 2, centre.z), packed);
 
     for (uint i = 0; i < segmentsCount; i++)
     {
@@ -420,10 +451,11 @@ void DebugDrawer::buildFilledCylinder(const Ogre::Vector3 &centre, float radius,
     }
 }
 
-void DebugDrawer::buildCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
 {
-    uint index = addLineVertex(vertices[0], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    for (uint i = 1; i < 8; ++i) addLineVertex(vertices[i], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    const Ogre::uint32 packed = packColour(colour, alpha);
+    uint index = addLineVertex(vertices[0], packed);
+    for (uint i = 1; i < 8; ++i) addLineVertex(vertices[i], packed);
 
     for (uint i = 0; i < 4; ++i) addLineIndices(index + i, index + ((i + 1) % 4));
     for (uint i = 4; i < 8; ++i) addLineIndices(index + i, i == 7 ? index + 4 : index + i + 1);
@@ -433,10 +465,11 @@ void DebugDrawer::buildCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourV
     addLineIndices(index + 3, index + 7);
 }
 
-void DebugDrawer::buildFilledCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildFilledCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
 {
-    uint index = addTriangleVertex(vertices[0], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    for (uint i = 1; i < 8; ++i) addTriangleVertex(vertices[i], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    const Ogre::uint32 packed = packColour(colour, alpha);
+    uint index = addTriangleVertex(vertices[0], packed);
+    for (uint i = 1; i < 8; ++i) addTriangleVertex(vertices[i], packed);
 
     addQuadIndices(index,     index + 1, index + 2, index + 3);
     addQuadIndices(index + 4, index + 5, index + 6, index + 7);
@@ -448,27 +481,30 @@ void DebugDrawer::buildFilledCuboid(const Ogre::Vector3 *vertices, const Ogre::C
     addQuadIndices(index + 4, index + 7, index + 3, index + 2);
 }
 
-void DebugDrawer::buildFilledQuad(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildFilledQuad(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
 {
-    uint index = addTriangleVertex(vertices[0], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addTriangleVertex(vertices[1], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addTriangleVertex(vertices[2], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addTriangleVertex(vertices[3], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    const Ogre::uint32 packed = packColour(colour, alpha);
+    uint index = addTriangleVertex(vertices[0], packed);
+    addTriangleVertex(vertices[1], packed);
+    addTriangleVertex(vertices[2], packed);
+    addTriangleVertex(vertices[3], packed);
 
     addQuadIndices(index, index + 1, index + 2, index + 3);
 }
 
-void DebugDrawer::buildFilledTriangle(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
+void DebugGeometry::buildFilledTriangle(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha)
 {
-    uint index = addTriangleVertex(vertices[0], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addTriangleVertex(vertices[1], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addTriangleVertex(vertices[2], Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    const Ogre::uint32 packed = packColour(colour, alpha);
+    uint index = addTriangleVertex(vertices[0], packed);
+    addTriangleVertex(vertices[1], packed);
+    addTriangleVertex(vertices[2], packed);
 
     addTriangleIndices(index, index + 1, index + 2);
 }
 
-void DebugDrawer::buildTetrahedron(const Ogre::Vector3 &centre, float scale, const Ogre::ColourValue &colour, float alpha)
+void DebugGeometry::buildTetrahedron(const Ogre::Vector3 &centre, float scale, const Ogre::ColourValue &colour, float alpha)
 {
+    const Ogre::uint32 packed = packColour(colour, alpha);
     uint index = linesIndex;
 
     // Distance from the centre
@@ -478,14 +514,10 @@ void DebugDrawer::buildTetrahedron(const Ogre::Vector3 &centre, float scale, con
     float backDistance = scale * 0.577f;
     float leftRightDistance = scale * 0.5f;
 
-    addLineVertex(Ogre::Vector3(centre.x, centre.y + topDistance, centre.z),
-        Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addLineVertex(Ogre::Vector3(centre.x, centre.y - bottomDistance, centre.z + frontDistance),
-        Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addLineVertex(Ogre::Vector3(centre.x + leftRightDistance, centre.y - bottomDistance, centre.z - backDistance),
-        Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addLineVertex(Ogre::Vector3(centre.x - leftRightDistance, centre.y - bottomDistance, centre.z - backDistance),
-        Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    addLineVertex(Ogre::Vector3(centre.x, centre.y + topDistance, centre.z), packed);
+    addLineVertex(Ogre::Vector3(centre.x, centre.y - bottomDistance, centre.z + frontDistance), packed);
+    addLineVertex(Ogre::Vector3(centre.x + leftRightDistance, centre.y - bottomDistance, centre.z - backDistance), packed);
+    addLineVertex(Ogre::Vector3(centre.x - leftRightDistance, centre.y - bottomDistance, centre.z - backDistance), packed);
 
     addLineIndices(index, index + 1);
     addLineIndices(index, index + 2);
@@ -496,8 +528,9 @@ void DebugDrawer::buildTetrahedron(const Ogre::Vector3 &centre, float scale, con
     addLineIndices(index + 3, index + 1);
 }
 
-void DebugDrawer::buildFilledTetrahedron(const Ogre::Vector3 &centre, float scale, const Ogre::ColourValue &colour, float alpha)
+void DebugGeometry::buildFilledTetrahedron(const Ogre::Vector3 &centre, float scale, const Ogre::ColourValue &colour, float alpha)
 {
+    const Ogre::uint32 packed = packColour(colour, alpha);
     uint index = trianglesIndex;
 
     // Distance from the centre
@@ -507,14 +540,10 @@ void DebugDrawer::buildFilledTetrahedron(const Ogre::Vector3 &centre, float scal
     float backDistance = scale * 0.577f;
     float leftRightDistance = scale * 0.5f;
 
-    addTriangleVertex(Ogre::Vector3(centre.x, centre.y + topDistance, centre.z),
-        Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addTriangleVertex(Ogre::Vector3(centre.x, centre.y - bottomDistance, centre.z + frontDistance),
-        Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addTriangleVertex(Ogre::Vector3(centre.x + leftRightDistance, centre.y - bottomDistance, centre.z - backDistance),
-        Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
-    addTriangleVertex(Ogre::Vector3(centre.x - leftRightDistance, centre.y - bottomDistance, centre.z - backDistance),
-        Ogre::ColourValue(colour.r, colour.g, colour.b, alpha));
+    addTriangleVertex(Ogre::Vector3(centre.x, centre.y + topDistance, centre.z), packed);
+    addTriangleVertex(Ogre::Vector3(centre.x, centre.y - bottomDistance, centre.z + frontDistance), packed);
+    addTriangleVertex(Ogre::Vector3(centre.x + leftRightDistance, centre.y - bottomDistance, centre.z - backDistance), packed);
+    addTriangleVertex(Ogre::Vector3(centre.x - leftRightDistance, centre.y - bottomDistance, centre.z - backDistance), packed);
 
     addTriangleIndices(index, index + 1, index + 2);
     addTriangleIndices(index, index + 2, index + 3);
@@ -525,88 +554,113 @@ void DebugDrawer::buildFilledTetrahedron(const Ogre::Vector3 &centre, float scal
 
 void DebugDrawer::drawLine(const Ogre::Vector3& start, const Ogre::Vector3& end, const Ogre::ColourValue& colour)
 {
-    buildLine(start, end, colour);
+    local().buildLine(start, end, colour);
 }
 
 void DebugDrawer::drawCircle(const Ogre::Vector3 &centre, float radius, uint segmentsCount, const Ogre::ColourValue& colour, bool isFilled)
 {
-    buildCircle(centre, radius, segmentsCount, colour);
-    if (isFilled) buildFilledCircle(centre, radius, segmentsCount, colour, fillAlpha);
+    DebugGeometry &geometry = local();
+    geometry.buildCircle(centre, radius, segmentsCount, colour);
+    if (isFilled) geometry.buildFilledCircle(centre, radius, segmentsCount, colour, fillAlpha);
 }
 
 void DebugDrawer::drawCylinder(const Ogre::Vector3 &centre, float radius, uint segmentsCount, float height, const Ogre::ColourValue& colour, bool isFilled)
 {
-    buildCylinder(centre, radius, segmentsCount, height, colour);
-    if (isFilled) buildFilledCylinder(centre, radius, segmentsCount, height, colour, fillAlpha);
+    DebugGeometry &geometry = local();
+    geometry.buildCylinder(centre, radius, segmentsCount, height, colour);
+    if (isFilled) geometry.buildFilledCylinder(centre, radius, segmentsCount, height, colour, fillAlpha);
 }
 
 void DebugDrawer::drawQuad(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, bool isFilled)
 {
-    buildQuad(vertices, colour);
-    if (isFilled) buildFilledQuad(vertices, colour, fillAlpha);
+    DebugGeometry &geometry = local();
+    geometry.buildQuad(vertices, colour);
+    if (isFilled) geometry.buildFilledQuad(vertices, colour, fillAlpha);
 }
 
 void DebugDrawer::drawCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, bool isFilled)
 {
-    buildCuboid(vertices, colour);
-    if (isFilled) buildFilledCuboid(vertices, colour, fillAlpha);
+    DebugGeometry &geometry = local();
+    geometry.buildCuboid(vertices, colour);
+    if (isFilled) geometry.buildFilledCuboid(vertices, colour, fillAlpha);
 }
 
 void DebugDrawer::drawSphere(const Ogre::Vector3 &centre, float radius, const Ogre::ColourValue& colour, bool isFilled)
 {
-    uint baseIndex = linesIndex;
-    linesIndex += icoSphere.addToVertices(&lineVertices, centre, colour, radius);
-    icoSphere.addToLineIndices(baseIndex, &lineIndices);
-
-    if (isFilled)
-    {
-        baseIndex = trianglesIndex;
-        trianglesIndex += icoSphere.addToVertices(&triangleVertices, centre, Ogre::ColourValue(colour.r, colour.g, colour.b, fillAlpha), radius);
-        icoSphere.addToTriangleIndices(baseIndex, &triangleIndices);
-    }
+    DebugGeometry &geometry = local();
+    geometry.buildSphere(*icoSphere, centre, radius, colour, colour.a);
+    if (isFilled) geometry.buildFilledSphere(*icoSphere, centre, radius, colour, fillAlpha);
 }
 
 void DebugDrawer::drawTetrahedron(const Ogre::Vector3 &centre, float scale, const Ogre::ColourValue& colour, bool isFilled)
 {
-    buildTetrahedron(centre, scale, colour);
-    if (isFilled) buildFilledTetrahedron(centre, scale, colour, fillAlpha);
+    DebugGeometry &geometry = local();
+    geometry.buildTetrahedron(centre, scale, colour);
+    if (isFilled) geometry.buildFilledTetrahedron(centre, scale, colour, fillAlpha);
 }
 
-void DebugDrawer::build()
+DebugGeometry &DebugDrawer::local()
 {
-    manualObject->beginUpdate(0);
-    if (lineVertices.size() > 0 && isEnabled)
+    if (localDrawer != id)
     {
-        manualObject->estimateVertexCount(lineVertices.size());
-        manualObject->estimateIndexCount(lineIndices.size());
-        for (std::list<VertexPair>::iterator i = lineVertices.begin(); i != lineVertices.end(); i++)
+        DebugGeometry *geometry = new DebugGeometry(colourType);
         {
-                manualObject->position(i->first);
-                manualObject->colour(i->second);
+            std::lock_guard<std::mutex> lock(threadGeometriesMutex);
+            threadGeometries.push_back(geometry);
         }
-        for (std::list<uint>::iterator i = lineIndices.begin(); i != lineIndices.end(); i++)
-            manualObject->index(*i);
+        localGeometry = geometry;
+        localDrawer = id;
     }
-    manualObject->end();
+    return *localGeometry;
+}
 
-    manualObject->beginUpdate(1);
-    if (triangleVertices.size() > 0 && isEnabled)
+void DebugDrawer::merge()
+{
+    std::lock_guard<std::mutex> lock(threadGeometriesMutex);
+    for (std::vector<DebugGeometry*>::iterator i = threadGeometries.begin(); i != threadGeometries.end(); i++)
     {
-        manualObject->estimateVertexCount(triangleVertices.size());
-        manualObject->estimateIndexCount(triangleIndices.size());
-        for (std::list<VertexPair>::iterator i = triangleVertices.begin(); i != triangleVertices.end(); i++)
-        {
-                manualObject->position(i->first);
-                manualObject->colour(i->second.r, i->second.g, i->second.b, fillAlpha);
-        }
-        for (std::list<uint>::iterator i = triangleIndices.begin(); i != triangleIndices.end(); i++)
-            manualObject->index(*i);
+        frameGeometry.append(**i);
+        (*i)->clear();
+    }
+}
+
+void DebugDrawer::build()
+{
+    if (isEnabled)
+    {
+        lines->update(frameGeometry.lineVertices, frameGeometry.lineIndices);
+        triangles->update(frameGeometry.triangleVertices, frameGeometry.triangleIndices);
+    }
+    else
+    {
+        lines->update(std::vector<DebugVertex>(), std::vector<Ogre::uint32>());
+        triangles->update(std::vector<DebugVertex>(), std::vector<Ogre::uint32>());
     }
-    manualObject->end();
 }
 
 void DebugDrawer::clear()
 {
+    frameGeometry.clear();
+
+    std::lock_guard<std::mutex> lock(threadGeometriesMutex);
+    for (std::vector<DebugGeometry*>::iterator i = threadGeometries.begin(); i != threadGeometries.end(); i++)
+        (*i)->clear();
+}
+
+DebugGeometry::DebugGeometry(Ogre::VertexElementType _colourType)
+    : lineVertices()
+    , triangleVertices()
+    , lineIndices()
+    , triangleIndices()
+    , colourType(_colourType)
+    , linesIndex(0)
+    , trianglesIndex(0)
+{
+}
+
+void DebugGeometry::clear()
+{
+    // Capacity is kept for next frame
     lineVertices.clear();
     triangleVertices.clear();
     lineIndices.clear();
@@ -614,32 +668,66 @@ void DebugDrawer::clear()
     linesIndex = trianglesIndex = 0;
 }
 
-uint DebugDrawer::addLineVertex(const Ogre::Vector3 &vertex, const Ogre::ColourValue &colour)
+void DebugGeometry::append(const DebugGeometry &geometry)
+{
+    lineVertices.insert(lineVertices.end(), geometry.lineVertices.begin(), geometry.lineVertices.end());
+    lineIndices.reserve(lineIndices.size() + geometry.lineIndices.size());
+    for (std::vector<Ogre::uint32>::const_iterator i = geometry.lineIndices.begin(); i != geometry.lineIndices.end(); i++)
+        lineIndices.push_back(linesIndex + *i);
+    linesIndex += geometry.linesIndex;
+
+    triangleVertices.insert(triangleVertices.end(), geometry.triangleVertices.begin(), geometry.triangleVertices.end());
+    triangleIndices.reserve(triangleIndices.size() + geometry.triangleIndices.size());
+    for (std::vector<Ogre::uint32>::const_iterator i = geometry.triangleIndices.begin(); i != geometry.triangleIndices.end(); i++)
+        triangleIndices.push_back(trianglesIndex + *i);
+    trianglesIndex += geometry.trianglesIndex;
+}
+
+void DebugGeometry::buildSphere(const IcoSphere &icoSphere, const Ogre::Vector3 &centre, float radius, const Ogre::ColourValue& colour, float alpha)
+{
+    uint baseIndex = linesIndex;
+    linesIndex += icoSphere.addToVertices(&lineVertices, centre, packColour(colour, alpha), radius);
+    icoSphere.addToLineIndices(baseIndex, &lineIndices);
+}
+
+void DebugGeometry::buildFilledSphere(const IcoSphere &icoSphere, const Ogre::Vector3 &centre, float radius, const Ogre::ColourValue& colour, float alpha)
+{
+    uint baseIndex = trianglesIndex;
+    trianglesIndex += icoSphere.addToVertices(&triangleVertices, centre, packColour(colour, alpha), radius);
+    icoSphere.addToTriangleIndices(baseIndex, &triangleIndices);
+}
+
+Ogre::uint32 DebugGeometry::packColour(const Ogre::ColourValue &colour, float alpha) const
+{
+    return Ogre::VertexElement::convertColourValue(Ogre::ColourValue(colour.r, colour.g, colour.b, alpha), colourType);
+}
+
+uint DebugGeometry::addLineVertex(const Ogre::Vector3 &vertex, Ogre::uint32 colour)
 {
-    lineVertices.push_back(VertexPair(vertex, colour));
+    lineVertices.push_back(DebugVertex(vertex, colour));
     return linesIndex++;
 }
 
-void DebugDrawer::addLineIndices(uint index1, uint index2)
+void DebugGeometry::addLineIndices(uint index1, uint index2)
 {
     lineIndices.push_back(index1);
     lineIndices.push_back(index2);
 }
 
-uint DebugDrawer::addTriangleVertex(const Ogre::Vector3 &vertex, const Ogre::ColourValue &colour)
+uint DebugGeometry::addTriangleVertex(const Ogre::Vector3 &vertex, Ogre::uint32 colour)
 {
-    triangleVertices.push_back(VertexPair(vertex, colour));
+    triangleVertices.push_back(DebugVertex(vertex, colour));
     return trianglesIndex++;
 }
 
-void DebugDrawer::addTriangleIndices(uint index1, uint index2, uint index3)
+void DebugGeometry::addTriangleIndices(uint index1, uint index2, uint index3)
 {
     triangleIndices.push_back(index1);
     triangleIndices.push_back(index2);
     triangleIndices.push_back(index3);
 }
 
-void DebugDrawer::addQuadIndices(uint index1, uint index2, uint index3, uint index4)
+void DebugGeometry::addQuadIndices(uint index1, uint index2, uint index3, uint index4)
 {
     triangleIndices.push_back(index1);
     triangleIndices.push_back(index2);
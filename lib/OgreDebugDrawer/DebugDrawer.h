@@ -8,61 +8,133 @@
 #define DEBUGDRAWER_H_INCLUDED
 
 #include <OGRE/OgreSingleton.h>
+#include <OGRE/OgreSimpleRenderable.h>
+#include <OGRE/OgreHardwareVertexBuffer.h>
+#include <OGRE/OgreHardwareIndexBuffer.h>
 #include <map>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
 
-typedef std::pair<Ogre::Vector3, Ogre::ColourValue> VertexPair;
+// Vertex of debug geometry, layout of hardware vertex buffer
+struct DebugVertex
+{
+    float x, y, z;
+    Ogre::uint32 colour; // Packed in vertex colour format of render system
+
+    DebugVertex(const Ogre::Vector3 &position, Ogre::uint32 _colour) : x(position.x), y(position.y), z(position.z), colour(_colour) {}
+};
 
 #define DEFAULT_ICOSPHERE_RECURSION_LEVEL    1
 
+// Unit sphere mesh in flat arrays. Spheres are built once per recursion
+// level and shared read only by all drawers and threads.
 class IcoSphere
 {
 public:
-    struct TriangleIndices
-    {
-        uint v1, v2, v3;
+    IcoSphere(int recursionLevel);
 
-        TriangleIndices(uint _v1, uint _v2, uint _v3) : v1(_v1), v2(_v2), v3(_v3) {}
+    // Sphere of recursion level, built by first request
+    static const IcoSphere &get(int recursionLevel);
 
-        bool operator < (const TriangleIndices &o) const { return v1 < o.v1 && v2 < o.v2 && v3 < o.v3; }
-    };
+    uint getVertexCount() const { return static_cast<uint>(vertices.size()); }
 
-    struct LineIndices
-    {
-        uint v1, v2;
+    void addToLineIndices(uint baseIndex, std::vector<Ogre::uint32> *target) const;
+    uint addToVertices(std::vector<DebugVertex> *target, const Ogre::Vector3 &position, Ogre::uint32 colour, float scale) const;
+    void addToTriangleIndices(uint baseIndex, std::vector<Ogre::uint32> *target) const;
+
+private:
+    typedef std::unordered_map<uint64_t, uint> EdgeCache;
 
-        LineIndices(uint _v1, uint _v2) : v1(_v1), v2(_v2) {}
+    uint addVertex(const Ogre::Vector3 &vertex);
+    uint getMiddlePoint(uint index0, uint index1, EdgeCache &middlePoints);
+
+    static uint64_t edgeKey(uint index0, uint index1);
+
+    std::vector<Ogre::Vector3> vertices;
+    std::vector<Ogre::uint32> lineIndices; // Unique edges of faces
+    std::vector<Ogre::uint32> triangleIndices;
+};
 
-        bool operator == (const LineIndices &o) const
-        {
-            return (v1 == o.v1 && v2 == o.v2) || (v1 == o.v2 && v2 == o.v1);
-        }
-    };
+// Geometry of one operation type in dynamic hardware buffers with 32-bit indices.
+// Buffers are kept between frames and grow only when geometry does not fit.
+class DebugRenderable
+    : public Ogre::SimpleRenderable
+{
+public:
+    DebugRenderable(Ogre::RenderOperation::OperationType type);
+    ~DebugRenderable();
 
-    IcoSphere();
-    ~IcoSphere();
+    // Write frame geometry with buffers discard
+    void update(const std::vector<DebugVertex> &vertices, const std::vector<Ogre::uint32> &indices);
 
-    void create(int recursionLevel);
-    void addToLineIndices(uint baseIndex, std::list<uint> *target);
-    uint addToVertices(std::list<VertexPair> *target, const Ogre::Vector3 &position, const Ogre::ColourValue &colour, float scale);
-    void addToTriangleIndices(uint baseIndex, std::list<uint> *target);
+    Ogre::Real getSquaredViewDepth(const Ogre::Camera *) const { return 0.0f; }
+    Ogre::Real getBoundingRadius() const { return 0.0f; }
 
 private:
-    uint addVertex(const Ogre::Vector3 &vertex);
-    void addLineIndices(uint index0, uint index1);
-    void addTriangleLines(uint index0, uint index1, uint index2);
-    uint getMiddlePoint(uint index0, uint index1);
-    void addFace(uint index0, uint index1, uint index2);
+    DebugRenderable(const DebugRenderable& obj);
+    DebugRenderable& operator=(const DebugRenderable& obj);
 
-    void removeLineIndices(uint index0, uint index1);
+    void reserve(size_t vertexCount, size_t indexCount);
 
-    std::vector<Ogre::Vector3> vertices;
-    std::list<LineIndices> lineIndices;
-    std::list<int> triangleIndices;
-    std::list<TriangleIndices> faces;
-    std::map<uint64_t, uint> middlePointIndexCache;
-    uint index;
+    Ogre::HardwareVertexBufferSharedPtr vertexBuffer;
+    Ogre::HardwareIndexBufferSharedPtr indexBuffer;
+    size_t vertexCapacity, indexCapacity;
+};
+
+// Debug geometry of one thread. Thread appends to its own geometry without
+// locks, drawer merges geometries of all threads once per frame.
+class DebugGeometry
+{
+public:
+    DebugGeometry(Ogre::VertexElementType _colourType);
+
+    void clear();
+
+    // Append geometry with shifted indices
+    void append(const DebugGeometry &geometry);
+
+    void buildLine(const Ogre::Vector3& start, const Ogre::Vector3& end, const Ogre::ColourValue& colour, float alpha = 1.0f);
+    void buildQuad(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
+    void buildFilledQuad(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
+    void buildFilledTriangle(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
+    void buildCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
+    void buildFilledCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
+
+    void buildCircle(const Ogre::Vector3 &centre, float radius, uint segmentsCount, const Ogre::ColourValue& colour, float alpha = 1.0f);
+    void buildFilledCircle(const Ogre::Vector3 &centre, float radius, uint segmentsCount, const Ogre::ColourValue& colour, float alpha = 1.0f);
+
+    void buildCylinder(const Ogre::Vector3 &centre, float radius, uint segmentsCount, float height, const Ogre::ColourValue& colour, float alpha = 1.0f);
+    void buildFilledCylinder(const Ogre::Vector3 &centre, float radius, uint segmentsCount, float height, const Ogre::ColourValue& colour, float alpha = 1.0f);
+
+    void buildSphere(const IcoSphere &icoSphere, const Ogre::Vector3 &centre, float radius, const Ogre::ColourValue& colour, float alpha = 1.0f);
+    void buildFilledSphere(const IcoSphere &icoSphere, const Ogre::Vector3 &centre, float radius, const Ogre::ColourValue& colour, float alpha = 1.0f);
+
+    void buildTetrahedron(const Ogre::Vector3 &centre, float scale, const Ogre::ColourValue &colour, float alpha = 1.0f);
+    void buildFilledTetrahedron(const Ogre::Vector3 &centre, float scale, const Ogre::ColourValue &colour, float alpha = 1.0f);
+
+    // Arrays keep capacity between frames
+    std::vector<DebugVertex> lineVertices, triangleVertices;
+    std::vector<Ogre::uint32> lineIndices, triangleIndices;
+
+private:
+    Ogre::VertexElementType colourType;
+    uint linesIndex, trianglesIndex;
+
+    Ogre::uint32 packColour(const Ogre::ColourValue &colour, float alpha) const;
+
+    uint addLineVertex(const Ogre::Vector3 &vertex, Ogre::uint32 colour);
+    void addLineIndices(uint index1, uint index2);
+
+    uint addTriangleVertex(const Ogre::Vector3 &vertex, Ogre::uint32 colour);
+    void addTriangleIndices(uint index1, uint index2, uint index3);
+
+    void addQuadIndices(uint index1, uint index2, uint index3, uint index4);
 };
 
+// Draw functions may be called by any thread. Frame geometry is collected
+// by main thread: merge() and build() when drawing threads are done, then
+// clear() before next frame drawing.
 class DebugDrawer
     : public Ogre::Singleton<DebugDrawer>
 {
@@ -73,6 +145,9 @@ public:
     static DebugDrawer& getSingleton(void);
     static DebugDrawer* getSingletonPtr(void);
 
+    // Collect geometry of all threads into frame geometry
+    void merge();
+
     void build();
 
     void setIcoSphereRecursionLevel(int recursionLevel);
@@ -96,43 +171,26 @@ private:
     DebugDrawer& operator=(const DebugDrawer& obj);
 
     Ogre::SceneManager *sceneManager;
-    Ogre::ManualObject *manualObject;
+    Ogre::SceneNode *sceneNode;
+    DebugRenderable *lines, *triangles;
+    Ogre::VertexElementType colourType;
     float fillAlpha;
-    IcoSphere icoSphere;
+    const IcoSphere *icoSphere;
 
     bool isEnabled;
 
-    std::list<VertexPair> lineVertices, triangleVertices;
-    std::list<uint> lineIndices, triangleIndices;
+    DebugGeometry frameGeometry;
+    std::vector<DebugGeometry*> threadGeometries;
+    std::mutex threadGeometriesMutex;
+    unsigned long id;
 
-    uint linesIndex, trianglesIndex;
+    static unsigned long nextId;
 
     void initialise();
     void shutdown();
 
-    void buildLine(const Ogre::Vector3& start, const Ogre::Vector3& end, const Ogre::ColourValue& colour, float alpha = 1.0f);
-    void buildQuad(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
-    void buildFilledQuad(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
-    void buildFilledTriangle(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
-    void buildCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
-    void buildFilledCuboid(const Ogre::Vector3 *vertices, const Ogre::ColourValue& colour, float alpha = 1.0f);
-
-    void buildCircle(const Ogre::Vector3 &centre, float radius, uint segmentsCount, const Ogre::ColourValue& colour, float alpha = 1.0f);
-    void buildFilledCircle(const Ogre::Vector3 &centre, float radius, uint segmentsCount, const Ogre::ColourValue& colour, float alpha = 1.0f);
-
-    void buildCylinder(const Ogre::Vector3 &centre, float radius, uint segmentsCount, float height, const Ogre::ColourValue& colour, float alpha = 1.0f);
-    void buildFilledCylinder(const Ogre::Vector3 &centre, float radius, uint segmentsCount, float height, const Ogre::ColourValue& colour, float alpha = 1.0f);
-
-    void buildTetrahedron(const Ogre::Vector3 &centre, float scale, const Ogre::ColourValue &colour, float alpha = 1.0f);
-    void buildFilledTetrahedron(const Ogre::Vector3 &centre, float scale, const Ogre::ColourValue &colour, float alpha = 1.0f);
-
-    uint addLineVertex(const Ogre::Vector3 &vertex, const Ogre::ColourValue &colour);
-    void addLineIndices(uint index1, uint index2);
-
-    uint addTriangleVertex(const Ogre::Vector3 &vertex, const Ogre::ColourValue &colour);
-    void addTriangleIndices(uint index1, uint index2, uint index3);
-
-    void addQuadIndices(uint index1, uint index2, uint index3, uint index4);
+    // Geometry of calling thread, created by first draw of thread
+    DebugGeometry &local();
 };
 
 #endif
@@ -29,6 +29,7 @@ class RigidBodyState : public btMotionState
 {
     protected:
         btTransform mTransform;
+        btTransform mPreviousTransform;
         btTransform mCenterOfMassOffset;
 
         Ogre::SceneNode *mNode;
@@ -36,6 +37,7 @@ class RigidBodyState : public btMotionState
     public:
         RigidBodyState(Ogre::SceneNode *node, const btTransform &transform, const btTransform &offset = btTransform::getIdentity())
             : mTransform(transform),
+              mPreviousTransform(transform),
               mCenterOfMassOffset(offset),
               mNode(node)
         {
@@ -44,6 +46,7 @@ class RigidBodyState : public btMotionState
         RigidBodyState(Ogre::SceneNode *node)
             : mTransform(((node != NULL) ? BtOgre::Convert::toBullet(node->getOrientation()) : btQuaternion(0,0,0,1)),
                          ((node != NULL) ? BtOgre::Convert::toBullet(node->getPosition())    : btVector3(0,0,0))),
+              mPreviousTransform(mTransform),
               mCenterOfMassOffset(btTransform::getIdentity()),
               mNode(node)
         {
@@ -54,13 +57,33 @@ class RigidBodyState : public btMotionState
             ret = mCenterOfMassOffset.inverse() * mTransform;
         }
 
+        //Stores transform of the last simulation tick. Node is updated by interpolate().
         virtual void setWorldTransform(const btTransform &in)
+        {
+            mTransform = in;
+        }
+
+        //Call before every simulation tick: remembers transform to interpolate from.
+        void saveTransform()
+        {
+            mPreviousTransform = mTransform;
+        }
+
+        //Moves node between previous and last tick transforms (alpha in [0, 1]).
+        void interpolate(btScalar alpha)
         {
             if (mNode == NULL)
                 return;
 
-            mTransform = in;
-            btTransform transform = in * mCenterOfMassOffset;
+            btTransform transform;
+            if (alpha >= btScalar(1.0) || (mPreviousTransform == mTransform))
+                transform = mTransform * mCenterOfMassOffset;
+            else
+            {
+                transform.setOrigin(mPreviousTransform.getOrigin().lerp(mTransform.getOrigin(), alpha));
+                transform.setRotation(mPreviousTransform.getRotation().slerp(mTransform.getRotation(), alpha));
+                transform = transform * mCenterOfMassOffset;
+            }
 
             btQuaternion rot = transform.getRotation();
             btVector3 pos = transform.getOrigin();
@@ -11,16 +11,22 @@
  *
  */
 
+#define LOG_SUBSYSTEM Common::CLog::SYS_DATA ///< Log subsystem of file
+
 #include "CData.h"
+#include "CDataSnapshot.h"
 
 #include <cstring>
-#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#include <map>
 
 CData::CData(const char* name)
     : m_dataRoot()
-    , m_dataBefore()
     , m_data()
     , m_dataName(name)
+    , m_dataSources()
+    , m_dataRoots()
 {
     m_data = m_dataRoot.append_child(CONFIG_TD_NAME).append_child(name);
     m_dataRoot.child(CONFIG_TD_NAME).append_attribute("version").set_value(CONFIG_TD_VERSION);
@@ -34,12 +40,21 @@ bool CData::loadData(const char* datafile)
 {
     log_info("Loading %s data file: \"%s\"", m_dataName, datafile);
 
+    // Absent file is source too, snapshot gets outdated when it will be created
+    m_dataSources.push_back(datafile);
+
+    if( CDataSnapshot::check(datafile) )
+        return loadSnapshot(datafile, false);
+
     pugi::xml_document new_data;
     pugi::xml_parse_result result = new_data.load_file(datafile, pugi::parse_full);
 
 #ifdef CONFIG_DEBUG
-    log_debug("New data for merge:");
-    new_data.save(std::cout, "  ");
+    if( Common::CLog::enabled(LOG_SUBSYSTEM, Common::CLog::LOG_DEBUG) )
+    {
+        log_debug("New data for merge:");
+        new_data.save(std::cout, "  ");
+    }
 #endif
 
     if( !result )
@@ -53,17 +68,89 @@ bool CData::loadData(const char* datafile)
     pugi::xml_node new_child = new_data.child(CONFIG_TD_NAME).child(m_dataName);
     mergeData(new_child);
 
+    for( pugi::xml_node_iterator it = new_child.begin(); it != new_child.end(); ++it )
+    {
+        if( (it->type() == pugi::node_element)
+            && (std::find(m_dataRoots.begin(), m_dataRoots.end(), it->name()) == m_dataRoots.end()) )
+            m_dataRoots.push_back(it->name());
+    }
+
 #ifdef CONFIG_DEBUG
-    log_debug("Data before merge:");
-    m_dataBefore.save(std::cout, "  ");
-    log_debug("Data After merge:");
-    m_dataRoot.save(std::cout, "  ");
+    if( Common::CLog::enabled(LOG_SUBSYSTEM, Common::CLog::LOG_DEBUG) )
+    {
+        log_debug("Data After merge:");
+        m_dataRoot.save(std::cout, "  ");
+    }
 #endif
 
     log_info("\tComplete loading %s data file: \"%s\"", m_dataName, datafile);
     return true;
 }
 
+bool CData::loadSnapshot(const char* path, bool check)
+{
+    CDataSnapshot snapshot;
+    if( ! snapshot.read(path) )
+        return false;
+
+    if( check && ! snapshot.actual() )
+    {
+        log_info("Data snapshot \"%s\" is outdated", path);
+        return false;
+    }
+
+    // Replace nodes loaded from files
+    std::vector<std::string> roots = snapshot.roots();
+    for( std::vector<std::string>::iterator it = roots.begin(); it != roots.end(); ++it )
+    {
+        while( m_data.child(it->c_str()) )
+            m_data.remove_child(it->c_str());
+
+        if( std::find(m_dataRoots.begin(), m_dataRoots.end(), *it) == m_dataRoots.end() )
+            m_dataRoots.push_back(*it);
+    }
+    snapshot.restore(m_data);
+
+    if( check )
+        m_dataSources = snapshot.sources();
+
+    log_info("Restored %s data from snapshot \"%s\"", m_dataName, path);
+
+    return true;
+}
+
+bool CData::saveSnapshot(const char* path) const
+{
+    CDataSnapshot snapshot;
+    for( std::vector<std::string>::const_iterator it = m_dataSources.begin(); it != m_dataSources.end(); ++it )
+        snapshot.source(it->c_str());
+
+    for( pugi::xml_node_iterator it = m_data.begin(); it != m_data.end(); ++it )
+    {
+        if( (it->type() == pugi::node_element)
+            && (std::find(m_dataRoots.begin(), m_dataRoots.end(), it->name()) != m_dataRoots.end()) )
+            snapshot.add(*it);
+    }
+
+    boost::system::error_code ec;
+    fs::path dir = fs::path(path).parent_path();
+    if( ! dir.empty() && ! fs::is_directory(dir, ec) && ! fs::create_directories(dir, ec) )
+        return log_error("Can't create directory \"%s\" for data snapshot", dir.c_str());
+
+    return snapshot.write(path);
+}
+
+fs::path CData::cachePath(const char* datafile) const
+{
+    fs::path path(Common::getCachePath());
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s-%016llx.tds", m_dataName,
+                  static_cast<unsigned long long>(CDataSnapshot::hash(datafile, std::strlen(datafile))));
+
+    return path / name;
+}
+
 void CData::saveData(std::ostream& stream)
 {
     m_dataRoot.save(stream, "  ", pugi::format_default, pugi::xml_encoding::encoding_utf8);
@@ -123,10 +210,15 @@ bool CData::verifyData(pugi::xml_document& document) const
     return true;
 }
 
-bool CData::mergeData(pugi::xml_node& new_node, pugi::xml_node* cur_node)
+/** @brief Compare of node names by content
+ */
+struct SNameLess
 {
-    // @todo Review this function and create cool debug
+    inline bool operator()(const char* a, const char* b) const { return std::strcmp(a, b) < 0; }
+};
 
+bool CData::mergeData(pugi::xml_node& new_node, pugi::xml_node* cur_node)
+{
     // If running in first time
     if( cur_node == NULL )
     {
@@ -137,54 +229,65 @@ bool CData::mergeData(pugi::xml_node& new_node, pugi::xml_node* cur_node)
             throw EXCEPTION("Configuration is not valid");
         }
 
-        // Copy tree before merge
-        std::stringstream buffer(std::stringstream::in | std::stringstream::out);
-        m_dataRoot.save(buffer, "");
-        m_dataBefore.load(buffer);
-
         cur_node = &m_data;
     }
+
+    // First child of every name on current level, instead of child(name) scan for each new node
+    std::map<const char*, pugi::xml_node, SNameLess> index;
+    for( pugi::xml_node_iterator it = cur_node->begin(); it != cur_node->end(); ++it )
+    {
+        if( it->type() == pugi::node_element )
+            index.insert(std::make_pair(it->name(), *it));
+    }
+
     // Processing current level of tree
     pugi::xml_node cur_child;
 
-    for( auto it = new_node.begin(); it != new_node.end(); ++it )
+    for( pugi::xml_node_iterator it = new_node.begin(); it != new_node.end(); ++it )
     {
         log_debug("Processing NEW: %s, CUR: %s", it->name(), cur_node->name());
         // Append node, if it not set or use exist node
-        if( ! it->empty() )
+        if( it->type() == pugi::node_element )
         {
-            if( (it->type() == pugi::node_element) && (!cur_node->child(it->name()) || it->attribute("value") || it->attribute("id")) )
-                cur_child = cur_node->append_child(it->name());
-            else if( (it->type() == pugi::node_element) && cur_node->child(it->name()) )
-            {
-                cur_child = cur_node->child(it->name());
-                log_debug("\tGet bad child by name %s->%s", it->name(), cur_child.name());
-            }
-            else if( !cur_node->first_child() )
+            std::map<const char*, pugi::xml_node, SNameLess>::iterator found = index.find(it->name());
+            if( found == index.end() || it->attribute("value") || it->attribute("id") )
             {
-                cur_child = cur_node->append_child(it->type());
-                log_debug("\tAdd child by type %d->%d", it->type());
+                cur_child = cur_node->append_child(it->name());
+                if( found == index.end() )
+                    index.insert(std::make_pair(cur_child.name(), cur_child));
             }
             else
             {
-                cur_child = cur_node->child(it->type());
-                log_debug("\tGet child by type %d->%d", it->type(), cur_child.type());
+                cur_child = found->second;
+                log_debug("\tGet child by name %s->%s", it->name(), cur_child.name());
             }
         }
+        else if( !cur_node->first_child() )
+        {
+            cur_child = cur_node->append_child(it->type());
+            log_debug("\tAdd child by type %d", it->type());
+        }
+        else
+        {
+            cur_child = cur_node->child(it->type());
+            log_debug("\tGet child by type %d->%d", it->type(), cur_child.type());
+        }
 
         // Processing attributes
-        for( auto ait = it->attributes_begin(); ait != it->attributes_end(); ++ait )
+        for( pugi::xml_attribute_iterator ait = it->attributes_begin(); ait != it->attributes_end(); ++ait )
         {
+            pugi::xml_attribute attr = cur_child.attribute(ait->name());
+
             // Append attribute if it not present
-            if( ! cur_child.attribute(ait->name()) )
-                cur_child.append_attribute(ait->name());
+            if( ! attr )
+                attr = cur_child.append_attribute(ait->name());
 
             // Set value of attribute
-            cur_child.attribute(ait->name()).set_value(ait->value());
+            attr.set_value(ait->value());
         }
 
-        // Set value of node
-        if( it->value() )
+        // Set value of node, elements have no value
+        if( (it->type() != pugi::node_element) && cur_child && std::strcmp(cur_child.value(), it->value()) != 0 )
         {
             log_debug("\tSet value %s, %d->%d", it->value(), it->type(), cur_child.type());
             cur_child.set_value(it->value());
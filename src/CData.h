@@ -35,13 +35,41 @@ public:
 
     /** @brief Load data file for object
      *
-     * @param datafile - Path to xml data file
+     * @param datafile - Path to xml data file or data snapshot
      * @return bool
      *
-     * Merge with previous loaded data.
+     * Merge with previous loaded data. Data snapshot (see saveSnapshot)
+     * is restored without parsing and merge.
      */
     bool loadData(const char* datafile);
 
+    /** @brief Restore data loaded from files by snapshot
+     *
+     * @param path - Snapshot path
+     * @param check - Snapshot is used only if its source files are not changed
+     * @return bool - false if snapshot is absent, invalid or outdated
+     *
+     * Nodes from snapshot replace nodes with the same names, nodes created
+     * by program (not from files) are kept.
+     */
+    bool loadSnapshot(const char* path, bool check = true);
+
+    /** @brief Save data loaded from files into binary snapshot
+     *
+     * @param path - Snapshot path, directory is created if needed
+     * @return bool
+     *
+     * Snapshot keeps list of loaded files with its time and hash.
+     */
+    bool saveSnapshot(const char* path) const;
+
+    /** @brief Path to cached snapshot of data loaded from file
+     *
+     * @param datafile - Path to first loaded data file
+     * @return fs::path - File in user cache directory
+     */
+    fs::path cachePath(const char* datafile) const;
+
     /** @brief Convert object data into string format
      *
      * @param stream - Output stream (like std::cout or any file stream)
@@ -57,7 +85,7 @@ public:
      */
     bool verifyData(pugi::xml_document& document) const;
 
-    /** @brief Merging current data and new data. Current data root will be copied to m_dataBefore
+    /** @brief Merging current data and new data
      *
      * @param new_node - Merge with it container node
      * @param cur_node - For recurse
@@ -67,9 +95,10 @@ public:
 
 protected:
     pugi::xml_document  m_dataRoot; ///< XML Root, containing td data
-    pugi::xml_document  m_dataBefore; ///< Before merge dataRoot
     pugi::xml_node      m_data; ///< Data of object
     const char*         m_dataName; ///< Data container name
+    std::vector<std::string> m_dataSources; ///< Loaded data files
+    std::vector<std::string> m_dataRoots; ///< Names of data nodes loaded from files
 private:
     /** @brief Fake copy constructor
      *
@@ -0,0 +1,325 @@
+/**
+ * @file    CDataSnapshot.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Binary snapshot of XML data
+ *
+ *
+ */
+
+#define LOG_SUBSYSTEM Common::CLog::SYS_DATA ///< Log subsystem of file
+
+#include "CDataSnapshot.h"
+
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+
+const char CDataSnapshot::s_Magic[4] = { 'T', 'D', 'D', 'S' };
+const uint32_t CDataSnapshot::s_Version = 1;
+
+/** @brief Read whole file
+ *
+ * @param path - File path
+ * @param content - File content
+ * @return bool
+ */
+static bool readFile(const char* path, std::string& content)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if( ! file )
+        return false;
+
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    return ! file.bad();
+}
+
+CDataSnapshot::CDataSnapshot()
+    : m_Sources()
+    , m_Nodes()
+    , m_Attributes()
+    , m_Strings(1, '\0')
+    , m_Interned()
+{
+    m_Interned[""] = 0;
+}
+
+CDataSnapshot::~CDataSnapshot()
+{
+}
+
+uint32_t CDataSnapshot::intern(const char* str)
+{
+    std::map<std::string, uint32_t>::iterator it = m_Interned.find(str);
+    if( it != m_Interned.end() )
+        return it->second;
+
+    uint32_t offset = static_cast<uint32_t>(m_Strings.size());
+    m_Strings.insert(m_Strings.end(), str, str + std::strlen(str) + 1);
+    m_Interned[str] = offset;
+
+    return offset;
+}
+
+void CDataSnapshot::source(const char* path)
+{
+    SDataSource src;
+    src.m_Path = intern(path);
+    src.m_Exists = 0;
+    src.m_Time = 0;
+    src.m_Size = 0;
+    src.m_Hash = 0;
+
+    std::string content;
+    boost::system::error_code ec;
+    std::time_t time = fs::last_write_time(path, ec);
+    if( ! ec && readFile(path, content) )
+    {
+        // File changed in the same second may change again unnoticed by time, its content is always compared
+        src.m_Exists = (time + 1 >= std::time(NULL)) ? 2 : 1;
+        src.m_Time = static_cast<int64_t>(time);
+        src.m_Size = content.size();
+        src.m_Hash = hash(content.data(), content.size());
+    }
+
+    m_Sources.push_back(src);
+}
+
+void CDataSnapshot::add(const pugi::xml_node& node)
+{
+    size_t index = m_Nodes.size();
+
+    SDataNode rec;
+    rec.m_Type = static_cast<uint32_t>(node.type());
+    rec.m_Name = intern(node.name());
+    rec.m_Value = intern(node.value());
+    rec.m_Attribute = static_cast<uint32_t>(m_Attributes.size());
+    rec.m_Attributes = 0;
+    rec.m_End = 0;
+
+    for( pugi::xml_attribute_iterator it = node.attributes_begin(); it != node.attributes_end(); ++it )
+    {
+        SDataAttribute attr;
+        attr.m_Name = intern(it->name());
+        attr.m_Value = intern(it->value());
+        m_Attributes.push_back(attr);
+        rec.m_Attributes++;
+    }
+    m_Nodes.push_back(rec);
+
+    for( pugi::xml_node_iterator it = node.begin(); it != node.end(); ++it )
+        add(*it);
+
+    m_Nodes[index].m_End = static_cast<uint32_t>(m_Nodes.size());
+}
+
+bool CDataSnapshot::write(const char* path) const
+{
+    // Snapshot is replaced at once, reader never gets partially written file
+    std::string tmp_path(path);
+    tmp_path += ".tmp";
+
+    std::ofstream file(tmp_path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if( ! file )
+        return log_error("Can't create data snapshot \"%s\"", path);
+
+    SDataSnapshotHeader header;
+    std::memcpy(header.m_Magic, s_Magic, sizeof(header.m_Magic));
+    header.m_Version = s_Version;
+    header.m_Sources = static_cast<uint32_t>(m_Sources.size());
+    header.m_Nodes = static_cast<uint32_t>(m_Nodes.size());
+    header.m_Attributes = static_cast<uint32_t>(m_Attributes.size());
+    header.m_Strings = static_cast<uint32_t>(m_Strings.size());
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if( ! m_Sources.empty() )
+        file.write(reinterpret_cast<const char*>(&m_Sources[0]), static_cast<std::streamsize>(m_Sources.size() * sizeof(SDataSource)));
+    if( ! m_Nodes.empty() )
+        file.write(reinterpret_cast<const char*>(&m_Nodes[0]), static_cast<std::streamsize>(m_Nodes.size() * sizeof(SDataNode)));
+    if( ! m_Attributes.empty() )
+        file.write(reinterpret_cast<const char*>(&m_Attributes[0]), static_cast<std::streamsize>(m_Attributes.size() * sizeof(SDataAttribute)));
+    file.write(&m_Strings[0], static_cast<std::streamsize>(m_Strings.size()));
+    file.close();
+
+    if( ! file )
+        return log_error("Can't write data snapshot \"%s\"", path);
+
+    boost::system::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if( ec )
+        return log_error("Can't replace data snapshot \"%s\": %s", path, ec.message().c_str());
+
+    return true;
+}
+
+bool CDataSnapshot::read(const char* path)
+{
+    std::string content;
+    if( ! readFile(path, content) )
+        return false;
+
+    SDataSnapshotHeader header;
+    if( content.size() < sizeof(header) )
+        return log_error("File \"%s\" is not a data snapshot", path);
+    std::memcpy(&header, content.data(), sizeof(header));
+
+    if( std::memcmp(header.m_Magic, s_Magic, sizeof(header.m_Magic)) != 0 )
+        return log_error("File \"%s\" is not a data snapshot", path);
+    if( header.m_Version != s_Version )
+    {
+        log_warn("Data snapshot \"%s\" has unsupported version %u", path, header.m_Version);
+        return false;
+    }
+
+    size_t size = sizeof(header) + header.m_Sources * sizeof(SDataSource) + header.m_Nodes * sizeof(SDataNode)
+            + header.m_Attributes * sizeof(SDataAttribute) + header.m_Strings;
+    if( content.size() != size || header.m_Strings == 0 || content[size - 1] != '\0' )
+        return log_error("Data snapshot \"%s\" is corrupted", path);
+
+    const char* data = content.data() + sizeof(header);
+    m_Sources.resize(header.m_Sources);
+    if( header.m_Sources > 0 )
+        std::memcpy(&m_Sources[0], data, header.m_Sources * sizeof(SDataSource));
+    data += header.m_Sources * sizeof(SDataSource);
+    m_Nodes.resize(header.m_Nodes);
+    if( header.m_Nodes > 0 )
+        std::memcpy(&m_Nodes[0], data, header.m_Nodes * sizeof(SDataNode));
+    data += header.m_Nodes * sizeof(SDataNode);
+    m_Attributes.resize(header.m_Attributes);
+    if( header.m_Attributes > 0 )
+        std::memcpy(&m_Attributes[0], data, header.m_Attributes * sizeof(SDataAttribute));
+    data += header.m_Attributes * sizeof(SDataAttribute);
+    m_Strings.assign(data, data + header.m_Strings);
+    m_Interned.clear();
+
+    // References must stay inside of tables
+    for( size_t i = 0; i < m_Sources.size(); i++ )
+    {
+        if( m_Sources[i].m_Path >= header.m_Strings )
+            return log_error("Data snapshot \"%s\" is corrupted", path);
+    }
+    for( size_t i = 0; i < m_Nodes.size(); i++ )
+    {
+        const SDataNode& node = m_Nodes[i];
+        if( node.m_Name >= header.m_Strings || node.m_Value >= header.m_Strings || node.m_End <= i
+            || node.m_End > header.m_Nodes || static_cast<uint64_t>(node.m_Attribute) + node.m_Attributes > header.m_Attributes )
+            return log_error("Data snapshot \"%s\" is corrupted", path);
+    }
+    for( size_t i = 0; i < m_Attributes.size(); i++ )
+    {
+        if( m_Attributes[i].m_Name >= header.m_Strings || m_Attributes[i].m_Value >= header.m_Strings )
+            return log_error("Data snapshot \"%s\" is corrupted", path);
+    }
+
+    return true;
+}
+
+bool CDataSnapshot::actual() const
+{
+    std::string content;
+    for( std::vector<SDataSource>::const_iterator it = m_Sources.begin(); it != m_Sources.end(); ++it )
+    {
+        const char* path = string(it->m_Path);
+
+        boost::system::error_code ec;
+        std::time_t time = fs::last_write_time(path, ec);
+        if( ec )
+        {
+            if( it->m_Exists )
+            {
+                log_info("Data source \"%s\" was removed", path);
+                return false;
+            }
+            continue;
+        }
+        if( ! it->m_Exists )
+        {
+            log_info("Data source \"%s\" was created", path);
+            return false;
+        }
+
+        // Same time and size - file is not touched, otherwise content decides
+        if( it->m_Exists == 1 && static_cast<int64_t>(time) == it->m_Time && fs::file_size(path, ec) == it->m_Size && ! ec )
+            continue;
+
+        if( ! readFile(path, content) || content.size() != it->m_Size || hash(content.data(), content.size()) != it->m_Hash )
+        {
+            log_info("Data source \"%s\" was changed", path);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void CDataSnapshot::restore(pugi::xml_node& parent) const
+{
+    uint32_t index = 0;
+    while( index < m_Nodes.size() )
+        index = restore(parent, index);
+}
+
+uint32_t CDataSnapshot::restore(pugi::xml_node& parent, uint32_t index) const
+{
+    const SDataNode& rec = m_Nodes[index];
+
+    pugi::xml_node node = parent.append_child(static_cast<pugi::xml_node_type>(rec.m_Type));
+    if( rec.m_Name != 0 )
+        node.set_name(string(rec.m_Name));
+    if( rec.m_Value != 0 )
+        node.set_value(string(rec.m_Value));
+
+    for( uint32_t i = rec.m_Attribute; i < rec.m_Attribute + rec.m_Attributes; i++ )
+        node.append_attribute(string(m_Attributes[i].m_Name)).set_value(string(m_Attributes[i].m_Value));
+
+    uint32_t child = index + 1;
+    while( child < rec.m_End )
+        child = restore(node, child);
+
+    return rec.m_End;
+}
+
+std::vector<std::string> CDataSnapshot::sources() const
+{
+    std::vector<std::string> paths;
+    for( std::vector<SDataSource>::const_iterator it = m_Sources.begin(); it != m_Sources.end(); ++it )
+        paths.push_back(string(it->m_Path));
+
+    return paths;
+}
+
+std::vector<std::string> CDataSnapshot::roots() const
+{
+    std::vector<std::string> names;
+    for( uint32_t index = 0; index < m_Nodes.size(); index = m_Nodes[index].m_End )
+        names.push_back(string(m_Nodes[index].m_Name));
+
+    return names;
+}
+
+bool CDataSnapshot::check(const char* path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    char magic[sizeof(s_Magic)];
+
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, s_Magic, sizeof(magic)) == 0;
+}
+
+uint64_t CDataSnapshot::hash(const char* data, size_t size)
+{
+    uint64_t value = 14695981039346656037ULL;
+    for( size_t i = 0; i < size; i++ )
+    {
+        value ^= static_cast<unsigned char>(data[i]);
+        value *= 1099511628211ULL;
+    }
+
+    return value;
+}
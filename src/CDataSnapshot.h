@@ -0,0 +1,192 @@
+/**
+ * @file    CDataSnapshot.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Binary snapshot of XML data
+ *
+ *
+ */
+
+#ifndef CDATASNAPSHOT_H
+#define CDATASNAPSHOT_H
+
+#include "Common.h"
+#include "pugixml/pugixml.hpp"
+
+#include <cstdint>
+
+/** @brief Header of data snapshot file
+ *
+ * File is header, then arrays of SDataSource, SDataNode, SDataAttribute
+ * and string table in host byte order. Strings are referred by offset in
+ * string table, all records are aligned - file may be used from memory
+ * as is.
+ */
+struct SDataSnapshotHeader
+{
+    char                m_Magic[4];    ///< File signature "TDDS"
+    uint32_t            m_Version;     ///< Format version
+    uint32_t            m_Sources;     ///< Number of source files
+    uint32_t            m_Nodes;       ///< Number of nodes
+    uint32_t            m_Attributes;  ///< Number of attributes
+    uint32_t            m_Strings;     ///< Size of string table
+};
+
+/** @brief XML file merged into snapshot
+ */
+struct SDataSource
+{
+    uint32_t            m_Path;   ///< Path string
+    uint32_t            m_Exists; ///< File was present (2 - was modified just before snapshot)
+    int64_t             m_Time;   ///< Modification time
+    uint64_t            m_Size;   ///< File size
+    uint64_t            m_Hash;   ///< Content hash (FNV-1a)
+};
+
+/** @brief Node of tree, nodes are stored in document order
+ */
+struct SDataNode
+{
+    uint32_t            m_Type;       ///< pugi::xml_node_type
+    uint32_t            m_Name;       ///< Name string
+    uint32_t            m_Value;      ///< Value string
+    uint32_t            m_Attribute;  ///< First attribute
+    uint32_t            m_Attributes; ///< Number of attributes
+    uint32_t            m_End;        ///< Next node after subtree of this node
+};
+
+/** @brief Attribute of node
+ */
+struct SDataAttribute
+{
+    uint32_t            m_Name;  ///< Name string
+    uint32_t            m_Value; ///< Value string
+};
+
+/** @brief Flat table of XML subtrees with interned strings
+ */
+class CDataSnapshot
+{
+public:
+    CDataSnapshot();
+    ~CDataSnapshot();
+
+    /** @brief Add current state of source file
+     *
+     * @param path - Source file path, may be absent
+     */
+    void source(const char* path);
+
+    /** @brief Add subtree
+     *
+     * @param node - Root of subtree
+     */
+    void add(const pugi::xml_node& node);
+
+    /** @brief Write snapshot file
+     *
+     * @param path - Snapshot path
+     * @return bool
+     */
+    bool write(const char* path) const;
+
+    /** @brief Read snapshot file
+     *
+     * @param path - Snapshot path
+     * @return bool
+     */
+    bool read(const char* path);
+
+    /** @brief Source files are not changed since snapshot creation
+     *
+     * @return bool
+     */
+    bool actual() const;
+
+    /** @brief Append stored subtrees to node
+     *
+     * @param parent - New parent of subtrees
+     */
+    void restore(pugi::xml_node& parent) const;
+
+    /** @brief Paths of source files
+     *
+     * @return std::vector<std::string>
+     */
+    std::vector<std::string> sources() const;
+
+    /** @brief Names of stored subtrees roots
+     *
+     * @return std::vector<std::string>
+     */
+    std::vector<std::string> roots() const;
+
+    /** @brief File is a data snapshot
+     *
+     * @param path - File path
+     * @return bool
+     */
+    static bool check(const char* path);
+
+    /** @brief Content hash of sources
+     *
+     * @param data - Content
+     * @param size - Content size
+     * @return uint64_t - FNV-1a hash
+     */
+    static uint64_t hash(const char* data, size_t size);
+
+    static const char       s_Magic[4]; ///< File signature
+    static const uint32_t   s_Version;  ///< Current format version
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CDataSnapshot(const CDataSnapshot& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CDataSnapshot& operator=(const CDataSnapshot& obj);
+
+    /** @brief Offset of string in table, adds it once
+     *
+     * @param str - String
+     * @return uint32_t
+     */
+    uint32_t intern(const char* str);
+
+    /** @brief Create node and its subtree
+     *
+     * @param parent - Parent node
+     * @param index - Node index
+     * @return uint32_t - Index of next node after subtree
+     */
+    uint32_t restore(pugi::xml_node& parent, uint32_t index) const;
+
+    /** @brief String by offset
+     *
+     * @param offset - Offset in table
+     * @return const char*
+     */
+    inline const char* string(uint32_t offset) const { return &m_Strings[offset]; }
+
+    std::vector<SDataSource>        m_Sources;    ///< Source files
+    std::vector<SDataNode>          m_Nodes;      ///< Nodes table
+    std::vector<SDataAttribute>     m_Attributes; ///< Attributes table
+    std::vector<char>               m_Strings;    ///< String table
+    std::map<std::string, uint32_t> m_Interned;   ///< Offsets of added strings
+};
+
+#endif // CDATASNAPSHOT_H
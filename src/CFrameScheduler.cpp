@@ -0,0 +1,110 @@
+/**
+ * @file    CFrameScheduler.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Frame rate limiter
+ *
+ *
+ */
+
+#include "CFrameScheduler.h"
+
+#include <algorithm>
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    #include <windows.h>
+#else
+    #include <time.h>
+    #include <cerrno>
+#endif
+
+CFrameScheduler::CFrameScheduler(Ogre::Timer* timer, uint rate, unsigned long spin)
+    : m_pTimer(timer)
+    , m_Period(16666)
+    , m_Spin(spin)
+    , m_NextFrameTime(0)
+    , m_Frames(0)
+    , m_Missed(0)
+    , m_ReportMissed(0)
+    , m_ReportTime(0)
+{
+    this->rate(rate);
+    reset();
+}
+
+CFrameScheduler::~CFrameScheduler()
+{
+}
+
+void CFrameScheduler::rate(uint rate)
+{
+    if( rate == 0 )
+    {
+        log_warn("Bad frame rate 0, using 60 frames/sec");
+        rate = 60;
+    }
+
+    // Period is not shorter than 1 microsecond
+    m_Period = 1000000ul / std::min(rate, 1000000u);
+    if( m_Spin > m_Period )
+        m_Spin = m_Period;
+}
+
+void CFrameScheduler::reset()
+{
+    m_NextFrameTime = m_pTimer->getMicroseconds();
+    m_ReportTime = m_NextFrameTime;
+}
+
+void CFrameScheduler::wait()
+{
+    unsigned long now = m_pTimer->getMicroseconds();
+
+    if( now > m_NextFrameTime + m_Spin )
+    {
+        // Deadline missed: skip lost frames, but keep cadence phase
+        unsigned long lost = (now - m_NextFrameTime) / m_Period;
+        m_Missed += std::max(lost, 1ul);
+        m_NextFrameTime += lost * m_Period;
+
+        if( now - m_ReportTime >= 1000000 )
+        {
+            log_warn("Missed %lu frame deadlines (%u frames/sec)", m_Missed - m_ReportMissed, rate());
+            m_ReportMissed = m_Missed;
+            m_ReportTime = now;
+        }
+    }
+    else
+    {
+        // Sleep before spin window and busy-wait only inside it
+        if( m_NextFrameTime > now + m_Spin )
+            sleep(m_NextFrameTime - now - m_Spin);
+
+        while( m_pTimer->getMicroseconds() < m_NextFrameTime ) {  }
+    }
+
+    m_NextFrameTime += m_Period;
+    m_Frames++;
+}
+
+void CFrameScheduler::report() const
+{
+    log_notice("Frames: %lu scheduled at %u frames/sec, %lu deadlines missed", m_Frames, rate(), m_Missed);
+}
+
+void CFrameScheduler::sleep(unsigned long usec)
+{
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+    Sleep(static_cast<DWORD>(usec / 1000));
+#else
+    struct timespec req;
+    req.tv_sec = static_cast<time_t>(usec / 1000000);
+    req.tv_nsec = static_cast<long>((usec % 1000000) * 1000);
+    while( (nanosleep(&req, &req) == -1) && (errno == EINTR) ) {  }
+#endif
+}
@@ -0,0 +1,114 @@
+/**
+ * @file    CFrameScheduler.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Frame rate limiter
+ *
+ *
+ */
+
+#ifndef CFRAMESCHEDULER_H
+#define CFRAMESCHEDULER_H
+
+#include "Common.h"
+
+/** @brief Keeps frames on absolute deadlines with configured rate
+ *
+ *  Scheduler sleeps until the short spin window before deadline and busy-waits
+ * only inside this window. Deadlines are absolute (previous deadline + period),
+ * so the frame period does not drift with render time. If deadline is missed,
+ * lost frames are skipped without changing cadence phase.
+ */
+class CFrameScheduler
+{
+public:
+    /** @brief Constructor
+     *
+     * @param timer - Game timer
+     * @param rate - Frames per second
+     * @param spin - Busy-wait window before deadline (microseconds)
+     */
+    CFrameScheduler(Ogre::Timer* timer, uint rate = 60, unsigned long spin = 1000);
+
+    /** @brief Destructor
+     */
+    ~CFrameScheduler();
+
+    /** @brief Set target frame rate
+     *
+     * @param rate - Frames per second
+     */
+    void rate(uint rate);
+
+    /** @brief Get target frame rate
+     *
+     * @return uint
+     */
+    inline uint rate() const { return static_cast<uint>(1000000ul / m_Period); }
+
+    /** @brief Start cadence from current time
+     */
+    void reset();
+
+    /** @brief Wait for next frame deadline
+     *
+     * @return void
+     *
+     */
+    void wait();
+
+    /** @brief Number of scheduled frames
+     *
+     * @return unsigned long
+     */
+    inline unsigned long frames() const { return m_Frames; }
+
+    /** @brief Number of missed deadlines
+     *
+     * @return unsigned long
+     */
+    inline unsigned long missed() const { return m_Missed; }
+
+    /** @brief Log frames statistics
+     */
+    void report() const;
+
+    /** @brief Sleep current thread
+     *
+     * @param usec - Microseconds to sleep
+     */
+    static void sleep(unsigned long usec);
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CFrameScheduler(const CFrameScheduler& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CFrameScheduler& operator=(const CFrameScheduler& obj);
+
+    Ogre::Timer*        m_pTimer;        ///< Game timer
+    unsigned long       m_Period;        ///< Frame period (microseconds)
+    unsigned long       m_Spin;          ///< Busy-wait window (microseconds)
+    unsigned long       m_NextFrameTime; ///< Absolute deadline of next frame (microseconds)
+
+    unsigned long       m_Frames;        ///< Scheduled frames
+    unsigned long       m_Missed;        ///< Missed deadlines
+    unsigned long       m_ReportMissed;  ///< Missed deadlines at last warning
+    unsigned long       m_ReportTime;    ///< Time of last warning (microseconds)
+};
+
+#endif // CFRAMESCHEDULER_H
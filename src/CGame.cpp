@@ -11,7 +11,22 @@
  */
 
 #include "CGame.h"
+#include "CLogFormat.h"
+#include "CFrameScheduler.h"
+#include "CSimulationClock.h"
+#include "CThreadPool.h"
+#include "CStartup.h"
+#include "CProfiler.h"
+#include "World/CShapeCache.h"
 #include "Nerv/CSensor.h"
+#include "Nerv/CNervRecorder.h"
+#include "Nerv/CNervPlayback.h"
+
+#include <OGRE/OgreDefaultHardwareBufferManager.h>
+
+#ifdef CONFIG_BULLET_MULTITHREADED
+#   include <LinearMath/btThreads.h>
+#endif
 
 #include <algorithm>
 
@@ -20,18 +35,31 @@ CGame::CGame()
    , CControlled("Game")
    , m_pSceneMgr()
    , m_pCamera()
-   , m_oCurrentWorld()
    , m_pInputHandler()
    , m_pWindow()
    , m_pRoot()
    , m_pLogManager()
+   , m_pBufferManager()
    , m_pTimer(new Ogre::Timer())
-   , m_NextFrameTime(0)
+   , m_pFrameScheduler()
+   , m_pSimulationClock()
+   , m_pThreadPool()
+   , m_pStartup()
+   , m_ResourcesStep(0)
+   , m_MeshesStep(0)
+   , m_UserStep(0)
+   , m_ResourceLocations()
+   , m_pShapeCache()
+   , m_pTaskScheduler()
+   , m_pNervRecorder()
+   , m_pNervPlayback()
    , m_Worlds()
+   , m_oCurrentWorld()
    , m_pMainUser()
    , m_Users()
    , m_oCurrentUser()
    , m_ShutDown(false)
+   , m_Headless(false)
 {
     m_pTimer->reset();
 }
@@ -41,13 +69,41 @@ fs::path* CGame::s_pPrefix = NULL;
 
 CGame::~CGame()
 {
+    // Background steps of failed initialisation use resources
+    delete m_pStartup;
+
     for( m_oCurrentWorld=m_Worlds.begin() ; m_oCurrentWorld < m_Worlds.end(); m_oCurrentWorld++ )
         delete (*m_oCurrentWorld);
     for( m_oCurrentUser = m_Users.begin() ; m_oCurrentUser < m_Users.end(); m_oCurrentUser++ )
         delete (*m_oCurrentUser);
+    delete m_pShapeCache;
 
+    delete m_pNervPlayback;
+    delete m_pNervRecorder;
+    delete m_pFrameScheduler;
+    delete m_pSimulationClock;
+    delete m_pThreadPool;
     delete m_pTimer;
 
+#ifdef CONFIG_BULLET_MULTITHREADED
+    if( m_pTaskScheduler != NULL )
+    {
+        btSetTaskScheduler(btGetSequentialTaskScheduler());
+        delete m_pTaskScheduler;
+    }
+#endif
+
+    // Workers are stopped, their profile zones may be read
+#ifdef CONFIG_PROFILE
+    CProfiler::report();
+    if( *arg("profile") )
+        CProfiler::exportTrace(arg("profile"));
+    CProfiler::clear();
+#else
+    if( *arg("profile") )
+        log_warn("Profiler is not compiled, rebuild with CONFIG_PROFILE to write \"%s\"", arg("profile"));
+#endif
+
     // Remove debug drawer
     delete DebugDrawer::getSingletonPtr();
 
@@ -58,6 +114,7 @@ CGame::~CGame()
     windowClosed(m_pWindow);
 
     delete m_pRoot;
+    delete m_pBufferManager;
     delete m_pLogManager;
 
     delete s_pPrefix;
@@ -75,18 +132,50 @@ const char* CGame::getPrefix()
     return s_pPrefix->c_str();
 }
 
+bool CGame::loadArgs(int argc, char** argv)
+{
+    pugi::xml_node data_args = m_data.append_child("args");
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( std::strncmp(argv[i], "--", 2) != 0 || argv[i][2] == '\0' )
+        {
+            log_warn("Skipping unknown argument \"%s\"", argv[i]);
+            continue;
+        }
+
+        pugi::xml_node arg = data_args.append_child(argv[i] + 2);
+
+        // Flag without value
+        if( (i + 1 >= argc) || (std::strncmp(argv[i + 1], "--", 2) == 0) )
+            arg.append_child(pugi::node_pcdata).set_value("Yes");
+        else
+            arg.append_child(pugi::node_pcdata).set_value(argv[++i]);
+
+        log_info("Argument %s: %s", arg.name(), arg.child_value());
+    }
+
+    return true;
+}
+
 bool CGame::initialise()
 {
     log_info("Start initialisation");
 
+    // Independent steps are done by background threads while main thread initialises engines
+    m_pStartup = new CStartup(2);
+
     // Loading environment
     loadEnv();
 
-    // Loading global config
+    // Loading global config, merged global and user configs are cached until files are not changed
     fs::path config_path(CGame::getPrefix());
     config_path /= CONFIG_PATH_GLOBAL_CONFIG;
     config_path /= "config.xml";
-    loadData(config_path.c_str());
+    fs::path cache_path = cachePath(config_path.c_str());
+    bool cached = (std::strcmp(arg("cache"), "No") != 0) && loadSnapshot(cache_path.c_str());
+    if( ! cached )
+        loadData(config_path.c_str());
 
     // Loading user config
     config_path = fs::path(env("HOME"));
@@ -104,33 +193,103 @@ bool CGame::initialise()
             return log_error("Could't create user data directory \"%s\"");
     }
     config_path /= "config.xml";
-    if( ! loadData(config_path.c_str()) )
-        log_notice("Can't load user configuration \"%s\"", config_path.c_str());
+    if( ! cached )
+    {
+        if( ! loadData(config_path.c_str()) )
+            log_notice("Can't load user configuration \"%s\"", config_path.c_str());
+        saveSnapshot(cache_path.c_str());
+    }
+    m_pStartup->mark("Configs");
+
+    // Resource locations are found while OGRE creates window
+    probeResources();
+
+    // Runtime log levels of subsystems
+    pugi::xml_node log_config = config("log");
+    for( uint sys = 0; sys < Common::CLog::SYS_COUNT; sys++ )
+    {
+        const char* level_name = log_config.child("levels").child_value(Common::CLogFormat::subsystemName(sys));
+        if( ! *level_name )
+            continue;
+
+        Common::CLog::LogLevel level = Common::CLog::levelByName(level_name);
+        if( level != Common::CLog::LOG_NONE )
+            Common::CLog::level(static_cast<Common::CLog::Subsystem>(sys), level);
+        else
+            log_warn("Unknown log level \"%s\" of %s", level_name, Common::CLogFormat::subsystemName(sys));
+    }
+
+    // Logging by background thread, binary log needs it
+    bool binary_log = (std::strcmp(log_config.child_value("binary"), "Yes") == 0);
+    if( binary_log || std::strcmp(log_config.child_value("async"), "No") != 0 )
+    {
+        uint queue = 1024;
+        if( *log_config.child_value("queue") )
+            queue = Ogre::StringConverter::parseUnsignedInt(log_config.child_value("queue"), queue);
+
+        fs::path log_path;
+        if( *log_config.child_value("file") )
+            log_path = fs::path(env("HOME")) / path("user_data") / log_config.child_value("file");
+
+        Common::CLog::start(queue, log_path.c_str(), std::strcmp(log_config.child_value("console"), "No") != 0, binary_log);
+    }
 
     // Loading gettext messages for default locale on this machine
     config_path = CGame::getPrefix() / fs::path(path("root_data")) / path("locale");
     setLocale(config_path.c_str());
 
+    // Select simulation mode
+    m_Headless = (std::strcmp(arg("headless"), "Yes") == 0)
+            || (std::strcmp(config("simulation").child_value("headless"), "Yes") == 0)
+            || (*arg("play") != '\0');
+    m_pStartup->mark("Log and locale");
+
+    // Main user data is parsed while engines are initialised
+    if( ! m_Headless || *arg("play") )
+    {
+        fs::path skeleton_path = CUser::skeletonPath();
+        m_UserStep = m_pStartup->async("Prepare user data", [skeleton_path]() {
+            CUser::prepare(skeleton_path.c_str());
+        });
+    }
+
     // Initialise OGRE
-    initOgre();
+    if( m_Headless )
+        initOgreHeadless();
+    else
+        initOgre();
+    CStartup::Step ogre = m_pStartup->mark("OGRE");
+
+    // Mesh files are read while other engines are initialised
+    prepareMeshes(ogre);
 
     // Initialise Bullet
     initBullet();
 
     // Initialise OIS
-    initOIS();
+    if( ! m_Headless )
+        initOIS();
 
     // Initialise Sound
     initSound();
+    m_pStartup->mark("Bullet, OIS and sound");
 
     // Initialise Game
     initGame();
+    m_pStartup->mark("Game");
 
 #ifdef CONFIG_DEBUG
-    log_info("Init debug drawer");
-    new DebugDrawer(m_pSceneMgr, 0.5f);
+    if( ! m_Headless )
+    {
+        log_info("Init debug drawer");
+        new DebugDrawer(m_pSceneMgr, 0.5f);
+    }
 #endif
 
+    m_pStartup->report();
+    delete m_pStartup;
+    m_pStartup = NULL;
+
     log_info("Complete configuration");
 
     return true;
@@ -155,6 +314,10 @@ bool CGame::loadEnv()
     return true;
 }
 
+// OGRE initialisation messages
+#undef  LOG_SUBSYSTEM
+#define LOG_SUBSYSTEM Common::CLog::SYS_OGRE
+
 bool CGame::initOgre()
 {
     log_notice("Initialising OGRE graphic engine");
@@ -308,59 +471,191 @@ bool CGame::initOgre()
         log_warn("\tPlugins not found");
 
 
+    loadResources();
+
+    // Set default mipmap level (NB some APIs ignore this)
+    Ogre::TextureManager::getSingleton().setDefaultNumMipmaps(5);
+
+    return true;
+}
+
+bool CGame::initOgreHeadless()
+{
+    log_notice("Initialising OGRE scene engine without rendering");
+
+    // Creating OGRE log
+    fs::path log_path(env("HOME"));
+    log_path /= path("user_data");
+    log_path /= "ogre.log";
+    m_pLogManager = new Ogre::LogManager();
+    m_pLogManager->createLog(log_path.c_str(), true, false, false);
+
+    // Loading root object without render system
+    m_pRoot = new Ogre::Root("", "", "");
+
+    // Meshes need buffers - use software buffers instead of video memory
+    m_pBufferManager = new Ogre::DefaultHardwareBufferManager();
+
+    loadResources();
+
+    return true;
+}
+
+void CGame::probeResources()
+{
+    // Locations are copied - game data is not used by background thread
+    m_ResourceLocations.clear();
+    pugi::xml_node ogre_resources(config("ogre").child("resources"));
+    for( auto rg = ogre_resources.begin(); rg != ogre_resources.end(); rg++ )
+    {
+        for( auto res = rg->begin(); res != rg->end(); res++ )
+        {
+            if( res->attribute("value") )
+                m_ResourceLocations.push_back(SResourceLocation(rg->name(), res->name(), res->attribute("value").value()));
+            else
+                log_warn("\tFound bad resource without value: type \"%s\" in group \"%s\"", res->name(), rg->name());
+        }
+    }
+
+    // User data locations replace root data locations
+    fs::path full_user_data = fs::path(env("HOME")) / fs::path(path("user_data")) / fs::path(path("data"));
+    fs::path full_root_data = CGame::getPrefix() / fs::path(path("root_data")) / fs::path(path("data"));
+    log_info("Probing %lu resource locations in user_data (\"%s\") and root_data (\"%s\")"
+             , static_cast<unsigned long>(m_ResourceLocations.size()), full_user_data.c_str(), full_root_data.c_str());
+
+    m_ResourcesStep = m_pStartup->async("Probe resource locations", [this, full_user_data, full_root_data]() {
+        for( auto it = m_ResourceLocations.begin(); it != m_ResourceLocations.end(); it++ )
+        {
+            if( fs::exists(full_user_data / it->m_Value) )
+                it->m_Path = full_user_data / it->m_Value;
+            else if( fs::exists(full_root_data / it->m_Value) )
+                it->m_Path = full_root_data / it->m_Value;
+        }
+    });
+}
+
+void CGame::loadResources()
+{
     log_info("Preparing resources");
-    pugi::xml_node ogre_resources(ogre_config.child("resources"));
-    fs::path ogre_resource_location;
-    if( ogre_resources )
+    m_pStartup->wait(m_ResourcesStep);
+
+    std::string group;
+    for( auto it = m_ResourceLocations.begin(); it != m_ResourceLocations.end(); it++ )
     {
-        for( auto rg = ogre_resources.begin(); rg != ogre_resources.end(); rg++ )
+        if( it->m_Group != group )
         {
-            log_info("\tGroup \"%s\"", rg->name());
-            for( auto res = rg->begin(); res != rg->end(); res++ )
-            {
-                if( res->attribute("value") )
-                {
-                    fs::path full_user_data = fs::path(env("HOME")) / fs::path(path("user_data")) / fs::path(path("data"));
-                    fs::path full_root_data;
-                    ogre_resource_location = full_user_data / fs::path(res->attribute("value").value());
-                    if( !fs::exists(ogre_resource_location) )
-                    {
-                        full_root_data = CGame::getPrefix() / fs::path(path("root_data")) / fs::path(path("data"));
-                        ogre_resource_location = full_root_data / fs::path(res->attribute("value").value());
-                    }
-
-                    if( fs::exists(ogre_resource_location) )
-                    {
-                        log_info("\t%s, location \"%s\"", res->name(), ogre_resource_location.c_str());
-                        Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
-                                    ogre_resource_location.string(), std::string(res->name()), std::string(rg->name()));
-                    }
-                    else
-                        log_error("\tResource path \"%s\" not exists in user_data (\"%s\") and root_data (\"%s\")"
-                                  , res->attribute("value").value(), full_user_data.c_str(), full_root_data.c_str());
-                }
-                else
-                    log_warn("\tFound bad resource without value: type \"%s\"", rg->name(), res->name());
-            }
+            group = it->m_Group;
+            log_info("\tGroup \"%s\"", group.c_str());
+        }
+
+        if( ! it->m_Path.empty() )
+        {
+            log_info("\t%s, location \"%s\"", it->m_Type.c_str(), it->m_Path.c_str());
+            Ogre::ResourceGroupManager::getSingleton().addResourceLocation(it->m_Path.string(), it->m_Type, it->m_Group);
         }
+        else
+            log_error("\tResource path \"%s\" not exists in user_data and root_data", it->m_Value.c_str());
     }
+    m_ResourceLocations.clear();
 
     log_info("Loading all prepared resources");
     Ogre::ResourceGroupManager::getSingleton().initialiseAllResourceGroups();
+}
 
-    // Set default mipmap level (NB some APIs ignore this)
-    Ogre::TextureManager::getSingleton().setDefaultNumMipmaps(5);
+void CGame::prepareMeshes(uint after)
+{
+    // Meshes are created here, background thread only reads their files.
+    // Plain pointers: MeshManager keeps meshes, and reference counts of
+    // shared pointers are not atomic without OGRE thread support.
+    std::vector<Ogre::Resource*> meshes;
+    Ogre::ResourceGroupManager& groups = Ogre::ResourceGroupManager::getSingleton();
+    Ogre::StringVector group_names = groups.getResourceGroups();
+    for( auto group = group_names.begin(); group != group_names.end(); group++ )
+    {
+        Ogre::StringVectorPtr names = groups.findResourceNames(*group, "*.mesh");
+        for( auto name = names->begin(); name != names->end(); name++ )
+            meshes.push_back(Ogre::MeshManager::getSingleton().createOrRetrieve(*name, *group).first.get());
+    }
+    log_info("Preparing %lu meshes", static_cast<unsigned long>(meshes.size()));
 
-    return true;
+    auto prepare = [meshes]() {
+        for( auto mesh = meshes.begin(); mesh != meshes.end(); mesh++ )
+        {
+            // Broken mesh fails only when it is used
+            try {
+                (*mesh)->prepare();
+            }
+            catch( Ogre::Exception const& e ) {
+                log_warn("\tCan't prepare mesh \"%s\": %s", (*mesh)->getName().c_str(), e.getDescription().c_str());
+            }
+        }
+    };
+
+#if OGRE_THREAD_SUPPORT
+    m_MeshesStep = m_pStartup->async("Prepare meshes", prepare, std::vector<CStartup::Step>(1, after));
+#else
+    // Preparing reads resource group maps, main thread changes them by next steps
+    (void)after;
+    prepare();
+    m_MeshesStep = m_pStartup->mark("Prepare meshes");
+#endif
 }
 
+#undef  LOG_SUBSYSTEM
+#define LOG_SUBSYSTEM Common::CLog::SYS_GAME
+
 bool CGame::initBullet()
 {
     log_notice("Initialising Bullet physics engine");
 
+    pugi::xml_node physics_config = config("physics");
+    if( std::strcmp(physics_config.child_value("world"), "multithreaded") != 0 )
+        return true;
+
+#ifdef CONFIG_BULLET_MULTITHREADED
+    m_pTaskScheduler = btCreateDefaultTaskScheduler();
+    if( m_pTaskScheduler == NULL )
+        return log_warn("Bullet has no default task scheduler - using single threaded physics");
+
+    btSetTaskScheduler(m_pTaskScheduler);
+
+    uint threads = 0;
+    if( *physics_config.child_value("threads") )
+        threads = Ogre::StringConverter::parseUnsignedInt(physics_config.child_value("threads"), threads);
+    physicsThreads(threads);
+#else
+    log_warn("Multithreaded physics is not built (CONFIG_BULLET_MULTITHREADED) - using single threaded physics");
+#endif
+
     return true;
 }
 
+uint CGame::physicsThreads() const
+{
+#ifdef CONFIG_BULLET_MULTITHREADED
+    if( m_pTaskScheduler != NULL )
+        return static_cast<uint>(m_pTaskScheduler->getNumThreads());
+#endif
+    return 0;
+}
+
+bool CGame::physicsThreads(uint threads)
+{
+#ifdef CONFIG_BULLET_MULTITHREADED
+    if( m_pTaskScheduler != NULL )
+    {
+        if( threads == 0 )
+            threads = CThreadPool::hardwareThreads();
+        m_pTaskScheduler->setNumThreads(static_cast<int>(threads));
+        log_info("Physics threads: %u of %d", physicsThreads(), m_pTaskScheduler->getMaxNumThreads());
+        return true;
+    }
+#else
+    (void)threads;
+#endif
+    return false;
+}
+
 bool CGame::initOIS()
 {
     log_notice("Initialising OIS Nerv controlling system");
@@ -401,60 +696,196 @@ bool CGame::initGame()
     Ogre::Light* l = m_pSceneMgr->createLight("MainLight");
     l->setPosition(200,200,200);
 
-    log_info("Creating viewport");
-    // Create one viewport, entire window
-    Ogre::Viewport* vp = m_pWindow->addViewport(m_pCamera);
-    vp->setBackgroundColour(Ogre::ColourValue(0,0,0));
+    if( ! m_Headless )
+    {
+        log_info("Creating viewport");
+        // Create one viewport, entire window
+        Ogre::Viewport* vp = m_pWindow->addViewport(m_pCamera);
+        vp->setBackgroundColour(Ogre::ColourValue(0,0,0));
 
-    // Alter the camera aspect ratio to match the viewport
-    m_pCamera->setAspectRatio(Ogre::Real(vp->getActualWidth()) / Ogre::Real(vp->getActualHeight()));
+        // Alter the camera aspect ratio to match the viewport
+        m_pCamera->setAspectRatio(Ogre::Real(vp->getActualWidth()) / Ogre::Real(vp->getActualHeight()));
 
-    // Creating simple game info
-    createFrameListener();
+        // Creating simple game info
+        createFrameListener();
+    }
+
+    // Simulation clock
+    pugi::xml_node sim_config = config("simulation");
+    uint tick_rate = 120, max_ticks = 8;
+    if( *sim_config.child_value("tick_rate") )
+        tick_rate = Ogre::StringConverter::parseUnsignedInt(sim_config.child_value("tick_rate"), tick_rate);
+    if( *sim_config.child_value("max_ticks") )
+        max_ticks = Ogre::StringConverter::parseUnsignedInt(sim_config.child_value("max_ticks"), max_ticks);
+    m_pSimulationClock = new CSimulationClock(tick_rate, max_ticks);
+    log_info("Simulation: %u ticks/sec, max %u ticks per frame", m_pSimulationClock->rate(), max_ticks);
+
+    // Worlds update threads (0 - number of hardware threads)
+    uint threads = 0;
+    if( *sim_config.child_value("threads") )
+        threads = Ogre::StringConverter::parseUnsignedInt(sim_config.child_value("threads"), threads);
+    if( threads == 0 )
+        threads = CThreadPool::hardwareThreads();
+    if( physicsThreads() > 0 )
+    {
+        // Bullet task scheduler accepts jobs only from main thread
+        log_info("Worlds are updated sequentially - physics is multithreaded");
+        threads = 1;
+    }
+    m_pThreadPool = new CThreadPool(threads - 1);
+
+    // Collision shapes are shared by objects, geometry of meshes is cached until mesh files are not changed
+    fs::path shapes_path;
+    if( std::strcmp(arg("cache"), "No") != 0 )
+        shapes_path = fs::path(Common::getCachePath()) / "shapes";
+    m_pShapeCache = new CShapeCache(shapes_path.c_str());
 
     // Create worlds
     log_info("Creating worlds");
+    m_pStartup->wait(m_MeshesStep);
     m_Worlds.push_back(new CWorld());
+    m_Worlds.back()->init();
 
     // Registering actions
     registerActions();
 
     // Create users after all game initialised - used game actions
-    m_pMainUser = new CUser();
-    m_Users.push_back(m_pMainUser);
+    if( ! m_Headless || *arg("play") )
+    {
+        m_pStartup->wait(m_UserStep);
+        m_pMainUser = new CUser();
+        m_Users.push_back(m_pMainUser);
+    }
 
     return true;
 }
 
 void CGame::start()
 {
+    if( m_Headless )
+    {
+        simulate();
+        return;
+    }
+
     log_notice("Starting game");
 
-    // Now time for fixing framerate
-    unsigned long now;
+    // Frame rate limiter
+    pugi::xml_node frame_config = config("frame");
+    uint rate = 60;
+    unsigned long spin = 1000;
+    if( *frame_config.child_value("rate") )
+        rate = Ogre::StringConverter::parseUnsignedInt(frame_config.child_value("rate"), rate);
+    if( *frame_config.child_value("spin") )
+        spin = Ogre::StringConverter::parseUnsignedLong(frame_config.child_value("spin"), spin);
+    log_info("Frame rate: %u frames/sec, spin %lu usec", rate, spin);
+
+    m_pFrameScheduler = new CFrameScheduler(m_pTimer, rate, spin);
+
+    // Recording of main user input for headless playback
+    if( *arg("record") )
+    {
+        m_pNervRecorder = new CNervRecorder(m_pSimulationClock);
+        if( m_pNervRecorder->open(arg("record")) )
+            m_pInputHandler->recorder(m_pNervRecorder);
+    }
 
     // Main game loop
     while( !m_ShutDown )
     {
-        now = m_pTimer->getMicroseconds();
+        PROFILE_FRAME();
+
+        // Waiting for frame deadline
+        {
+            PROFILE_ZONE("CFrameScheduler::wait");
+            m_pFrameScheduler->wait();
+        }
+
+        // Get messages
+        Ogre::WindowEventUtilities::messagePump();
+
+        // Rendering scene
+        PROFILE_ZONE("Ogre::Root::renderOneFrame");
+        m_pRoot->renderOneFrame();
+        if( !m_pWindow->isActive() && m_pWindow->isVisible() )
+            m_pWindow->update();
+    }
+
+    // Input handler is destroyed with closed window
+    if( m_pInputHandler != NULL )
+        m_pInputHandler->recorder(NULL);
+    if( m_pNervRecorder != NULL )
+        m_pNervRecorder->close();
+
+    m_pFrameScheduler->report();
+}
+
+void CGame::simulate()
+{
+    pugi::xml_node sim_config = config("simulation");
+
+    // Number of ticks to run (0 - until exit)
+    unsigned long ticks_max = 0;
+    if( *arg("ticks") )
+        ticks_max = Ogre::StringConverter::parseUnsignedLong(arg("ticks"));
+    else if( *sim_config.child_value("ticks") )
+        ticks_max = Ogre::StringConverter::parseUnsignedLong(sim_config.child_value("ticks"));
+
+    const uint tick_rate = m_pSimulationClock->rate();
+    const Ogre::Real tick = m_pSimulationClock->tick();
+
+    // Recorded input replaces sensor, by default whole record is played
+    if( *arg("play") )
+    {
+        m_pNervPlayback = new CNervPlayback();
+        if( ! m_pNervPlayback->load(arg("play"), tick_rate) )
+            return;
+        if( ticks_max == 0 )
+            ticks_max = m_pNervPlayback->length() + 1;
+    }
+
+    log_notice("Starting headless simulation: %u ticks/sec, %lu ticks", tick_rate, ticks_max);
+
+    unsigned long ticks = 0, report_ticks = 0;
+    unsigned long start = m_pTimer->getMicroseconds();
+    unsigned long report = start;
+    unsigned long now;
+
+    // Main simulation loop
+    while( !m_ShutDown && (ticks_max == 0 || ticks < ticks_max) )
+    {
+        PROFILE_FRAME();
 
-        // Rendering:
-        if( m_NextFrameTime <= now )
+        if( m_pNervPlayback != NULL )
+            m_pNervPlayback->play(ticks, m_pMainUser);
+
+        updateWorlds(tick);
+        updateUsers(tick);
+        ticks++;
+
+        // Throughput report every second
+        now = m_pTimer->getMicroseconds();
+        if( now - report >= 1000000 )
         {
-            // Get messages
-            Ogre::WindowEventUtilities::messagePump();
-
-            // Rendering scene
-            m_pRoot->renderOneFrame();
-            m_NextFrameTime = now + 16666;
-            if( !m_pWindow->isActive() && m_pWindow->isVisible() )
-                m_pWindow->update();
+            log_notice("Simulation: tick #%lu, %.1f ticks/sec", ticks,
+                       static_cast<double>(ticks - report_ticks) * 1000000.0 / static_cast<double>(now - report));
+            report = now;
+            report_ticks = ticks;
         }
     }
+
+    double elapsed = static_cast<double>(m_pTimer->getMicroseconds() - start) / 1000000.0;
+    if( elapsed > 0.0 )
+        log_notice("Simulation complete: %lu ticks in %.3f sec, %.1f ticks/sec (%.2fx realtime)", ticks, elapsed,
+                   static_cast<double>(ticks) / elapsed, static_cast<double>(ticks) / static_cast<double>(tick_rate) / elapsed);
 }
 
 void CGame::getScreenshot()
 {
+    // Recorded screenshot action in headless playback
+    if( m_pWindow == NULL )
+        return;
+
     m_pWindow->writeContentsToTimestampedFile("screenshot", ".jpg");
 }
 
@@ -475,42 +906,95 @@ bool CGame::frameRenderingQueued(const Ogre::FrameEvent&)
     if(m_ShutDown)
         return false;
 
-    //Need to capture/update each device
-    m_pInputHandler->capture();
-
     return true;
 }
 
-void CGame::updateWorlds(const Ogre::Real time_since_last_frame)
+void CGame::updateWorlds(const Ogre::Real tick)
 {
+    PROFILE_ZONE("CGame::updateWorlds");
+
+    // Single world splits its systems between threads itself
+    if( m_Worlds.size() == 1 )
+    {
+        m_Worlds[0]->update(tick, m_pThreadPool);
+        return;
+    }
+
+#ifdef CONFIG_BULLET_PARALLEL_WORLDS
+    m_pThreadPool->parallel(static_cast<uint>(m_Worlds.size()), [this, tick](uint i) {
+        m_Worlds[i]->update(tick);
+    });
+#else
+    // Old bullet steps write to one global profiler
     for( m_oCurrentWorld=m_Worlds.begin() ; m_oCurrentWorld < m_Worlds.end(); m_oCurrentWorld++ )
-        (*m_oCurrentWorld)->update(time_since_last_frame);
+        (*m_oCurrentWorld)->update(tick);
+#endif
+}
+
+void CGame::interpolateWorlds(const Ogre::Real alpha)
+{
+    PROFILE_ZONE("CGame::interpolateWorlds");
+
+    for( m_oCurrentWorld=m_Worlds.begin() ; m_oCurrentWorld < m_Worlds.end(); m_oCurrentWorld++ )
+        (*m_oCurrentWorld)->interpolate(alpha);
 }
 
 void CGame::updateUsers(const Ogre::Real time_since_last_frame)
 {
+    PROFILE_ZONE("CGame::updateUsers");
+
     for( m_oCurrentUser = m_Users.begin() ; m_oCurrentUser < m_Users.end(); m_oCurrentUser++ )
         (*m_oCurrentUser)->update(time_since_last_frame);
 }
 
 bool CGame::frameStarted(const Ogre::FrameEvent& evt)
 {
-    // Updating worlds
-    updateWorlds(evt.timeSinceLastFrame);
+    PROFILE_ZONE("CGame::frameStarted");
+
+    // Updating worlds by fixed ticks, frame time may be any
+    uint ticks = m_pSimulationClock->advance(evt.timeSinceLastFrame);
+
+    // Simulated time ends before now by not simulated rest of frame
+    unsigned long tick_time = 1000000ul / m_pSimulationClock->rate();
+    unsigned long end = m_pTimer->getMicroseconds();
+    end -= std::min(end, static_cast<unsigned long>(m_pSimulationClock->alpha() * static_cast<Ogre::Real>(tick_time)));
+
+    // Polled signals are taken by last tick of frame
+    if( m_pInputHandler != NULL )
+        m_pInputHandler->capture(end);
+    for( uint i = 0; i < ticks; i++ )
+    {
+        // Input captured during simulated time of tick is sent before it
+        if( m_pInputHandler != NULL )
+        {
+            unsigned long before = (ticks - 1 - i) * tick_time;
+            m_pInputHandler->dispatch((end > before) ? end - before : 0, m_pSimulationClock->ticks() - ticks + i);
+        }
+        updateWorlds(m_pSimulationClock->tick());
+    }
+
+#ifdef CONFIG_DEBUG
+    // Debug geometry is drawn by worlds interpolation every frame
+    DebugDrawer::getSingleton().clear();
+#endif
+    interpolateWorlds(m_pSimulationClock->alpha());
+
     // Updating users
     updateUsers(evt.timeSinceLastFrame);
 
 #ifdef CONFIG_DEBUG
-    DebugDrawer::getSingleton().build();
+    {
+        PROFILE_ZONE("DebugDrawer::build");
+        // Geometry drawn by world threads is collected here, they are done
+        DebugDrawer::getSingleton().merge();
+        DebugDrawer::getSingleton().build();
+    }
 #endif
     return true;
 }
 
 bool CGame::frameEnded(const Ogre::FrameEvent&)
 {
-#ifdef CONFIG_DEBUG
-    DebugDrawer::getSingleton().clear();
-#endif
     return true;
 }
 
@@ -520,22 +1004,26 @@ void CGame::windowResized(Ogre::RenderWindow* rw)
     int left, top;
     rw->getMetrics(width, height, depth, left, top);
 
-    const OIS::MouseState& ms = m_pInputHandler->getMouse()->getMouseState();
-    ms.width = static_cast<int>(width);
-    ms.height = static_cast<int>(height);
+    // Mouse state is owned by capture thread
+    if( m_pInputHandler != NULL )
+        m_pInputHandler->windowSize(width, height);
 }
 
 void CGame::windowClosed(Ogre::RenderWindow* rw)
 {
     // Only close for window that created OIS
     if( (rw == m_pWindow) && m_pInputHandler != NULL )
+    {
         delete m_pInputHandler;
+        m_pInputHandler = NULL;
+    }
 }
 
 void CGame::registerActions()
 {
     addAction('e', "Exit");
     addAction('s', "Screen Shot");
+    addAction('p', "Physics Debug");
     //addAction("Up");
     //addAction("Down");
     //addAction("Left");
@@ -557,6 +1045,11 @@ void CGame::doAction(char act, CSignal& sig)
             log_debug("ScreenShot action");
             getScreenshot();
             break;
+        case 'p':
+            log_debug("Physics debug action");
+            for( std::vector<CWorld*>::iterator it = m_Worlds.begin(); it != m_Worlds.end(); ++it )
+                (*it)->physicsDebug(! (*it)->physicsDebug());
+            break;
         }
     }
 }
@@ -30,6 +30,14 @@
 #include "CUser.h"
 
 class CSensor;
+class CFrameScheduler;
+class CSimulationClock;
+class CThreadPool;
+class CStartup;
+class CShapeCache;
+class CNervRecorder;
+class CNervPlayback;
+class btITaskScheduler;
 
 /** @brief Provides all game.
  */
@@ -64,6 +72,16 @@ public:
     static const char* getPrefix();
 
 
+    /** @brief Store command line arguments in game data
+     *
+     * @param argc - Number of arguments
+     * @param argv - Arguments array
+     * @return bool
+     *
+     * Arguments like "--name value" or "--flag" will be available by arg("name")
+     */
+    bool loadArgs(int argc, char** argv);
+
     /** @brief Preparation to game start
      *
      * @return bool
@@ -86,6 +104,13 @@ public:
      */
     inline void exit() { m_ShutDown = true; }
 
+    /** @brief Game is running without render window
+     *
+     * @return bool
+     *
+     */
+    inline bool headless() const { return m_Headless; }
+
     /** @brief Save screenshot
      *
      * @return void
@@ -100,6 +125,13 @@ public:
      */
     inline uint time() { return m_pTimer->getMilliseconds(); }
 
+    /** @brief Get time in microseconds since game start
+     *
+     * @return unsigned long - Number of microseconds since start
+     *
+     */
+    inline unsigned long microtime() { return m_pTimer->getMicroseconds(); }
+
 
     /** @brief Return environment variable
      *
@@ -115,6 +147,20 @@ public:
      */
     inline const char* path(const char* name) { return m_data.child("path").child_value(name); }
 
+    /** @brief Return command line argument
+     *
+     * @param name
+     * @return const char*
+     */
+    inline const char* arg(const char* name) { return m_data.child("args").child_value(name); }
+
+    /** @brief Return config section
+     *
+     * @param name
+     * @return pugi::xml_node
+     */
+    inline pugi::xml_node config(const char* name) { return m_data.child("config").child(name); }
+
     /** @brief Doing need actions
      *
      * @see CControlled::doAction()
@@ -127,12 +173,29 @@ public:
      */
     inline CSensor* inputHandler() { return m_pInputHandler; }
 
+    /** @brief Collision shapes shared by objects of all worlds
+     *
+     * @return CShapeCache*
+     */
+    inline CShapeCache* shapeCache() { return m_pShapeCache; }
+
+    /** @brief Number of physics worker threads of multithreaded worlds
+     *
+     * @return uint - 0 if worlds use single threaded physics
+     */
+    uint physicsThreads() const;
+
+    /** @brief Change number of physics worker threads
+     *
+     * @param threads - Number of threads (0 - all hardware threads)
+     * @return bool - false if multithreaded physics is not used
+     */
+    bool physicsThreads(uint threads);
+
 
     Ogre::SceneManager*                     m_pSceneMgr; ///< Scene Manager object
     Ogre::Camera*                           m_pCamera; ///< Main camera
 
-    std::vector<CWorld*>::iterator          m_oCurrentWorld; ///< Current processing world
-
 private:
     /** @brief Adding actions
      *
@@ -179,6 +242,39 @@ private:
      */
     bool initBullet();
 
+    /** @brief Init OGRE without render system and window
+     *
+     * @return bool
+     *
+     * Only scene graph, meshes and resources are available.
+     */
+    bool initOgreHeadless();
+
+    /** @brief Start search of resource locations from config in user and root data
+     *
+     * @return void
+     *
+     * Locations are checked by startup thread, loadResources waits for them.
+     */
+    void probeResources();
+
+    /** @brief Add resource locations from config to OGRE
+     *
+     * @return void
+     *
+     */
+    void loadResources();
+
+    /** @brief Start reading of all mesh files by startup thread
+     *
+     * @param after - Startup step of resources initialisation
+     * @return void
+     *
+     * Prepared mesh is loaded from memory when object creates it. OGRE
+     * without thread support prepares meshes by main thread.
+     */
+    void prepareMeshes(uint after);
+
     /** @brief Init OIS Nerv controlling system configuration
      *
      * @return bool
@@ -207,6 +303,13 @@ private:
      */
     void setLocale(const char* messages_path, const char* locale = "");
 
+    /** @brief Headless main loop - fixed timestep simulation without rendering
+     *
+     * @return void
+     *
+     */
+    void simulate();
+
     /** @brief Frame listener of window
      *
      */
@@ -220,13 +323,23 @@ private:
      */
     bool frameRenderingQueued(const Ogre::FrameEvent& evt);
 
-    /** @brief Updating worlds actions on every frame event
+    /** @brief Run one fixed simulation tick of all worlds
      *
-     * @param time_since_last_frame
+     * @param tick - Tick length in seconds
      * @return void
      *
+     * Worlds are independent and updated in parallel by thread pool,
+     * single world updates batches of its objects in parallel.
      */
-    void updateWorlds(const Ogre::Real time_since_last_frame);
+    void updateWorlds(const Ogre::Real tick);
+
+    /** @brief Interpolate worlds scene between two last simulation ticks
+     *
+     * @param alpha - Interpolation factor
+     * @return void
+     *
+     */
+    void interpolateWorlds(const Ogre::Real alpha);
 
     /** @brief Updating users state on every frame event
      *
@@ -270,6 +383,19 @@ private:
      */
     void windowClosed(Ogre::RenderWindow* rw);
 
+    /** @brief Resource location from config
+     */
+    struct SResourceLocation
+    {
+        SResourceLocation(const char* group, const char* type, const char* value)
+            : m_Group(group), m_Type(type), m_Value(value), m_Path() {  }
+
+        std::string     m_Group; ///< Resource group
+        std::string     m_Type;  ///< Location type (FileSystem, Zip)
+        std::string     m_Value; ///< Location relative to data directory
+        fs::path        m_Path;  ///< Found location, empty if not found
+    };
+
     static CGame*                           s_pInstance; ///< Instance of game
     static fs::path*                        s_pPrefix; ///< Current prefix directory
 
@@ -278,16 +404,30 @@ private:
 
     Ogre::Root*                             m_pRoot; ///< Root Ogre object
     Ogre::LogManager*                       m_pLogManager; ///< Log manager for replacement OGRE default logger
+    Ogre::HardwareBufferManager*            m_pBufferManager; ///< Software buffers for headless mode
     Ogre::Timer*                            m_pTimer; ///< Game timer for restriction of frame rendering speed
-    unsigned long                           m_NextFrameTime; ///< Render next frame in this time (microseconds)
+    CFrameScheduler*                        m_pFrameScheduler; ///< Frame rate limiter
+    CSimulationClock*                       m_pSimulationClock; ///< Fixed timestep clock of worlds simulation
+    CThreadPool*                            m_pThreadPool; ///< Worker threads for worlds update
+    CStartup*                               m_pStartup; ///< Startup steps, exists during initialisation
+    uint                                    m_ResourcesStep; ///< Startup step of resource locations search
+    uint                                    m_MeshesStep; ///< Startup step of meshes preparing
+    uint                                    m_UserStep; ///< Startup step of main user data parsing
+    std::vector<SResourceLocation>          m_ResourceLocations; ///< Resource locations from config
+    CShapeCache*                            m_pShapeCache; ///< Shared collision shapes of meshes
+    btITaskScheduler*                       m_pTaskScheduler; ///< Bullet task scheduler of multithreaded worlds
+    CNervRecorder*                          m_pNervRecorder; ///< Recorder of main user input
+    CNervPlayback*                          m_pNervPlayback; ///< Recorded input of headless simulation
 
     std::vector<CWorld*>                    m_Worlds; ///< Worlds list
+    std::vector<CWorld*>::iterator          m_oCurrentWorld; ///< Current processing world
 
     CUser*                                  m_pMainUser; ///< Link to main user
     std::vector<CUser*>                     m_Users; ///< Users list
     std::vector<CUser*>::iterator           m_oCurrentUser; ///< Current processing user
 
     bool                                    m_ShutDown; ///< Game need to stop
+    bool                                    m_Headless; ///< Simulation without rendering
 
 protected:
 };
@@ -13,73 +13,42 @@
  */
 
 
+#define LOG_SUBSYSTEM Common::CLog::SYS_WORLD ///< Log subsystem of file
+
 #include "CGravityField.h"
 #include "World/CWorld.h"
 #include "CGame.h"
 
-CGravityElement::CGravityElement(btVector3* box, btVector3* position, btVector3* force)
-    : m_pGravityObj(NULL)
-    , m_pForce(force)
-    , m_uid(0)
+CGravityElement::CGravityElement(const btVector3& box, const btVector3& position, const btVector3& force)
+    : m_Shape(box)
+    , m_GravityObj()
+    , m_Force(force)
     , m_status(ES_ENABLED)
 {
-    m_pGravityObj = new btCollisionObject();
-    m_pGravityObj->setCollisionShape(new btBoxShape(*box));
-    m_pGravityObj->getWorldTransform().setOrigin(*position);
+    m_GravityObj.setCollisionShape(&m_Shape);
+    m_GravityObj.setCollisionFlags(m_GravityObj.getCollisionFlags() | btCollisionObject::CF_NO_CONTACT_RESPONSE);
+    m_GravityObj.getWorldTransform().setOrigin(position);
 }
 
 CGravityElement::~CGravityElement()
 {
-    delete m_pGravityObj;
 }
 
 
-/** @brief Struct for auto-detecting objects in field
- */
-struct CGravityField::SForceFieldCallback : public btCollisionWorld::ContactResultCallback
-{
-    /** @brief Bullet auto-execute this function if object contacts with field
-     *
-     * @param cp
-     * @param colObj0
-     * @param partId0
-     * @param index0
-     * @param colObj1
-     * @param partId1
-     * @param index1
-     * @return virtual btScalar
-     *
-     */
-    virtual btScalar addSingleResult(btManifoldPoint&, const btCollisionObject* colObj0, int, int, const btCollisionObject* colObj1, int, int)
-    {
-        if (colObj1->getInternalType() == btCollisionObject::CO_RIGID_BODY)
-        {
-            CGravityField* gf = (*CGame::getInstance()->m_oCurrentWorld)->m_pGravityField;
-            gf->setObjectGravity(
-                colObj1->getBroadphaseHandle()->getUid(),
-                gf->get(colObj0->getBroadphaseHandle()->getUid())
-            );
-        }
-        else
-            log_debug("Connected to GravityField object is not regid body uid#%d", colObj1->getBroadphaseHandle()->getUid());
-
-        return 0;
-    }
-} CGravityField::m_callbackResult; ///< Callback object for Bullet
-
-
 CGravityField::CGravityField(CWorld* world, float gravityValue)
-    : m_ObjectInGravityField()
-    , m_ObjectGravityMap()
-    , m_GravityFieldMap()
-    , m_oGravityFieldMap(NULL)
+    : m_Objects()
+    , m_Elements()
+    , m_ElementsPool()
     , m_pWorld(world)
+    , m_Manifolds()
     , m_GravityValue(gravityValue)
 {
 }
 
 CGravityField::~CGravityField()
 {
+    while( ! m_Elements.empty() )
+        remove(m_Elements.handle(m_Elements.size() - 1));
 }
 
 void CGravityField::setGravityValue(float newGravity)
@@ -94,67 +63,132 @@ float CGravityField::getGravityValue()
 
 void CGravityField::catchFieldContact()
 {
-    for ( m_oGravityFieldMap = m_GravityFieldMap.begin() ; m_oGravityFieldMap != m_GravityFieldMap.end(); m_oGravityFieldMap++ )
-        m_pWorld->m_pPhyWorld->contactTest((*m_oGravityFieldMap).second->m_pGravityObj, m_callbackResult);
+    btOverlappingPairCache* pairs = m_pWorld->m_pPhyWorld->getPairCache();
+
+    for( CSlotMap<CGravityElement*>::iterator it = m_Elements.begin(); it != m_Elements.end(); it++ )
+    {
+        btGhostObject* ghost = &(*it)->m_GravityObj;
+
+        // Broadphase found objects with overlapping AABB, narrowphase was done by world step
+        for( int i = 0; i < ghost->getNumOverlappingObjects(); i++ )
+        {
+            btCollisionObject* obj = ghost->getOverlappingObject(i);
+            CObject* object = static_cast<CObject*>(obj->getUserPointer());
+            if( (object == NULL) || (obj->getInternalType() != btCollisionObject::CO_RIGID_BODY) )
+                continue;
+
+            btBroadphasePair* pair = pairs->findPair(ghost->getBroadphaseHandle(), obj->getBroadphaseHandle());
+            if( (pair == NULL) || (pair->m_algorithm == NULL) )
+                continue;
+
+            m_Manifolds.resize(0);
+            pair->m_algorithm->getAllContactManifolds(m_Manifolds);
+            for( int j = 0; j < m_Manifolds.size(); j++ )
+            {
+                if( m_Manifolds[j]->getNumContacts() > 0 )
+                {
+                    setObjectGravity(object->gravityHandle(), &(*it)->m_Force);
+                    break;
+                }
+            }
+        }
+    }
 }
 
-int CGravityField::add(CGravityElement* el)
+void CGravityField::clearObjectsInGravityField()
 {
-    m_pWorld->m_pPhyWorld->addCollisionObject(el->m_pGravityObj, CObject::FIELD_OBJECT, CObject::DYNAMIC_OBJECT);
-    el->m_uid = el->m_pGravityObj->getBroadphaseHandle()->getUid();
-    m_GravityFieldMap[el->m_uid] = el;
+    for( CSlotMap<SObjectGravity>::iterator it = m_Objects.begin(); it != m_Objects.end(); it++ )
+        it->m_InField = false;
+}
 
-    return el->m_uid;
+CGravityField::Handle CGravityField::add(const btVector3& box, const btVector3& position, const btVector3& force)
+{
+    CGravityElement* el = m_ElementsPool.create(box, position, force);
+    m_pWorld->m_pPhyWorld->addCollisionObject(&el->m_GravityObj, CObject::FIELD_OBJECT, CObject::DYNAMIC_OBJECT);
+
+    return m_Elements.add(el);
 }
 
-void CGravityField::remove(int elId)
+void CGravityField::remove(const Handle& el)
 {
-    // @todo fix this remove sigfault
-    m_pWorld->m_pPhyWorld->removeCollisionObject(m_GravityFieldMap[elId]->m_pGravityObj);
-    m_GravityFieldMap.erase(elId);
+    CGravityElement** element = m_Elements.get(el);
+    if( element == NULL )
+    {
+        log_error("Not found Gravity Field element #%u", el.m_Index);
+        return;
+    }
+
+    CGravityElement* removed = *element;
+    m_pWorld->m_pPhyWorld->removeCollisionObject(&removed->m_GravityObj);
+    m_Elements.remove(el);
+    m_ElementsPool.destroy(removed);
 }
 
-btVector3* CGravityField::get(int elId)
+btVector3* CGravityField::get(const Handle& el)
 {
-    if( m_GravityFieldMap.find(elId) != m_GravityFieldMap.end() )
-        return m_GravityFieldMap[elId]->m_pForce;
+    CGravityElement** element = m_Elements.get(el);
+    if( element != NULL )
+        return &(*element)->m_Force;
 
-    log_error("Not found Gravity Field with id#%d", elId);
+    log_error("Not found Gravity Field element #%u", el.m_Index);
     return NULL;
 }
 
-void CGravityField::enable(int elId)
+void CGravityField::enable(const Handle&)
 {
     // @todo create this function
 }
 
-void CGravityField::disable(int elId)
+void CGravityField::disable(const Handle&)
 {
     // @todo create this function
 }
 
-void CGravityField::zeroObjectGravity(int objectId, btVector3* gravity)
+CGravityField::Handle CGravityField::addObject()
 {
-    m_ObjectGravityMap[objectId] = (*gravity);
+    SObjectGravity state;
+    state.m_Gravity.setZero();
+    state.m_InField = false;
+
+    return m_Objects.add(state);
 }
 
-void CGravityField::setObjectGravity(int objectId, btVector3* gravity)
+void CGravityField::removeObject(const Handle& obj)
 {
+    m_Objects.remove(obj);
+}
+
+void CGravityField::setObjectGravity(const Handle& obj, const btVector3* gravity)
+{
+    SObjectGravity* state = m_Objects.get(obj);
+    if( state == NULL )
+        return;
+
     // Set the object located in a gravitational field
-    m_ObjectInGravityField[objectId] = true;
+    state->m_InField = true;
 
     // Change Gravity Vector
-    m_ObjectGravityMap[objectId] = m_ObjectGravityMap[objectId] + (*gravity);
+    state->m_Gravity += (*gravity);
 }
 
-btVector3 CGravityField::getObjectGravity(int objectId)
+btVector3 CGravityField::getObjectGravity(const Handle& obj)
 {
+    SObjectGravity* state = m_Objects.get(obj);
+    if( state == NULL )
+        return btVector3(0.0f, 0.0f, 0.0f);
+
     // Zeroficate gravity
-    btVector3 temp = m_ObjectGravityMap[objectId];
-    m_ObjectGravityMap[objectId].setZero();
+    btVector3 temp = state->m_Gravity;
+    state->m_Gravity.setZero();
 
     if( temp.length() != 0 )
         temp.normalize();
 
     return temp * m_GravityValue;
-};
+}
+
+bool CGravityField::isObjectInGravityField(const Handle& obj)
+{
+    SObjectGravity* state = m_Objects.get(obj);
+    return (state != NULL) && state->m_InField;
+}
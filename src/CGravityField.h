@@ -19,30 +19,37 @@
 
 #include "OGRE/Ogre.h"
 #include "World/CObject.h"
+#include "CSlotMap.h"
+#include "CPool.h"
 #include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionDispatch/btGhostObject.h>
 
 /** @brief Invisible box with gravity vector
+ *
+ * Box is a ghost object - broadphase keeps list of overlapping objects,
+ * so field does not need to query world for every element. Ghost object
+ * and its shape are parts of element, elements are allocated by pool of
+ * gravity field.
  */
 class CGravityElement
 {
 public:
     /** @brief Constructor of gravity element
      *
-     * @param box
+     * @param box - Half extents of box
      * @param position
      * @param force
      *
      */
-    CGravityElement(btVector3* box, btVector3* position, btVector3* force);
+    CGravityElement(const btVector3& box, const btVector3& position, const btVector3& force);
 
     /** @brief Destructor, cleaner of element
     */
     ~CGravityElement();
 
-    btCollisionObject*            m_pGravityObj; ///< Bullet collision object
-    btVector3*                    m_pForce; ///< Vector of gravity force
-
-    int                           m_uid; ///< Unique id of element
+    btBoxShape                    m_Shape; ///< Shape of ghost object
+    btGhostObject                 m_GravityObj; ///< Bullet ghost object
+    btVector3                     m_Force; ///< Vector of gravity force
 
     /** @brief Enumiration of status of element
      */
@@ -76,6 +83,8 @@ private:
 class CGravityField
 {
 public:
+    typedef SSlotHandle Handle; ///< Handle of element or object
+
     /** @brief Constructor of gravity field
      *
      * @param world
@@ -84,7 +93,7 @@ public:
      */
     CGravityField(CWorld* world, float gravityValue);
 
-    /** @brief Destructor of field
+    /** @brief Destructor of field, removes remaining elements
      */
     ~CGravityField();
 
@@ -109,94 +118,118 @@ public:
      *
      * @return void
      *
+     * Uses overlapping pairs of elements and contact manifolds of last
+     * simulation step, so must be called after world step.
      */
     void catchFieldContact();
 
     /** @brief Clearing all objects in field
      *
-     * @return void clearObjectsInGravityField(){
+     * @return void
      *
      */
-    inline void clearObjectsInGravityField() { m_ObjectInGravityField.clear(); }
+    void clearObjectsInGravityField();
 
 
     // For elements
     /** @brief Add new gravity element to field
      *
-     * @param el - Gravity element object
-     * @return int
+     * @param box - Half extents of element box
+     * @param position - Position of element
+     * @param force - Vector of gravity force
+     * @return Handle
      *
      */
-    int        add(CGravityElement* el);
+    Handle     add(const btVector3& box, const btVector3& position, const btVector3& force);
 
-    /** @brief Remove gravity element from field by id
+    /** @brief Remove gravity element from field
      *
-     * @param elId - Id of element
+     * @param el - Handle of element
      * @return void
      *
+     * Element is returned to pool and reused by next add.
      */
-    void       remove(int elId);
+    void       remove(const Handle& el);
 
-    /** @brief Get gravity element object by id
+    /** @brief Get gravity element force by handle
      *
-     * @param elId - Id of element
+     * @param el - Handle of element
      * @return btVector3*
      *
      */
-    btVector3* get(int elId);
+    btVector3* get(const Handle& el);
 
-    /** @brief Enabling gravity element by id
+    /** @brief Enabling gravity element
      *
-     * @param elId - Id of element
+     * @param el - Handle of element
      * @return void
      *
      */
-    void       enable(int elId);
+    void       enable(const Handle& el);
 
-    /** @brief Disable gravity element by id
+    /** @brief Disable gravity element
      *
-     * @param elId - Id of element
+     * @param el - Handle of element
      * @return void
      *
      */
-    void       disable(int elId);
+    void       disable(const Handle& el);
 
     // For objects
-    /** @brief Zeroing of object gravity
+    /** @brief Register object affected by field
      *
-     * @param objectId
-     * @param gravity
+     * @return Handle - Gravity state of object
+     *
+     */
+    Handle    addObject();
+
+    /** @brief Unregister object
+     *
+     * @param obj - Gravity state handle
      * @return void
      *
      */
-    void      zeroObjectGravity(int objectId, btVector3* gravity);
+    void      removeObject(const Handle& obj);
 
-    /** @brief Set gravity to object
+    /** @brief Add gravity to object
      *
-     * @param objectId
+     * @param obj - Gravity state handle
      * @param gravity
      * @return void
      *
      */
-    void      setObjectGravity(int objectId, btVector3* gravity);
+    void      setObjectGravity(const Handle& obj, const btVector3* gravity);
 
-    /** @brief Get object gravity
+    /** @brief Get object gravity and reset accumulated gravity vector
      *
-     * @param objectId
+     * @param obj - Gravity state handle
      * @return btVector3
      *
      */
-    btVector3 getObjectGravity(int objectId);
+    btVector3 getObjectGravity(const Handle& obj);
 
-    struct SForceFieldCallback; ///< Callback structure
-    static SForceFieldCallback   m_callbackResult; ///< Result of callback
+    /** @brief Object was in any gravity element on last check
+     *
+     * @param obj - Gravity state handle
+     * @return bool
+     *
+     */
+    bool      isObjectInGravityField(const Handle& obj);
 
 private:
-    std::map<int, bool>                         m_ObjectInGravityField; ///< Map causes object is in gravity field
-    std::map<int, btVector3>                    m_ObjectGravityMap; ///< Objects gravity vector
-    std::map<int, CGravityElement*>             m_GravityFieldMap; ///< Elements in field
-    std::map<int, CGravityElement*>::iterator   m_oGravityFieldMap; ///< Current processing gravity element
+    /** @brief Gravity state of object
+     */
+    struct SObjectGravity
+    {
+        btVector3   m_Gravity; ///< Sum of gravity vectors since last read
+        bool        m_InField; ///< Object is in gravity field
+    };
+
+    CSlotMap<SObjectGravity>                    m_Objects; ///< Objects gravity state
+    CSlotMap<CGravityElement*>                  m_Elements; ///< Elements in field
+    CObjectPool<CGravityElement>                m_ElementsPool; ///< Memory of elements
     CWorld*                                     m_pWorld; ///< Linked world object
+    btManifoldArray                             m_Manifolds; ///< Contact manifolds of processing pair
 
     float                                       m_GravityValue; ///< Force of gravity in field
 
@@ -0,0 +1,371 @@
+/**
+ * @file    CLogFormat.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Packed log messages and binary log format
+ *
+ *
+ */
+
+#include "CLogFormat.h"
+
+#include <cstring>
+#include <string>
+#include <algorithm>
+
+using namespace Common;
+
+const char CLogFormat::s_Magic[4] = { 'T', 'D', 'L', 'G' };
+const uint32_t CLogFormat::s_Version = 1;
+
+namespace
+{
+    /** @brief Put value into packed arguments
+     */
+    template<typename T> bool put(char* buffer, size_t size, size_t& pos, T value)
+    {
+        if( pos + sizeof(T) > size )
+            return false;
+        std::memcpy(buffer + pos, &value, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    /** @brief Get value from packed arguments
+     */
+    template<typename T> bool get(const char* args, size_t size, size_t& pos, T& value)
+    {
+        if( pos + sizeof(T) > size )
+            return false;
+        std::memcpy(&value, args + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    /** @brief Append formatted value to text
+     */
+    template<typename T> void append(char* text, size_t size, size_t& len, const char* spec, T value)
+    {
+        if( len + 1 >= size )
+            return;
+        int written = std::snprintf(text + len, size - len, spec, value);
+        if( written > 0 )
+            len = std::min(len + static_cast<size_t>(written), size - 1);
+    }
+
+    /** @brief Append raw text
+     */
+    void appendText(char* text, size_t size, size_t& len, const char* begin, const char* end)
+    {
+        size_t count = std::min(static_cast<size_t>(end - begin), size - 1 - len);
+        std::memcpy(text + len, begin, count);
+        len += count;
+    }
+
+    /** @brief Get packed integer of format length modifier and append it
+     */
+    template<typename S, typename U> bool appendInteger(char* text, size_t size, size_t& len, const char* spec, bool is_signed,
+                                                          const char* args, size_t args_size, size_t& pos)
+    {
+        if( is_signed )
+        {
+            S value;
+            if( ! get(args, args_size, pos, value) )
+                return false;
+            append(text, size, len, spec, value);
+        }
+        else
+        {
+            U value;
+            if( ! get(args, args_size, pos, value) )
+                return false;
+            append(text, size, len, spec, value);
+        }
+        return true;
+    }
+
+    /** @brief Pack integer of format length modifier
+     */
+    template<typename S, typename U> bool packInteger(char* buffer, size_t size, size_t& pos, bool is_signed, std::va_list& ap)
+    {
+        if( is_signed )
+            return put(buffer, size, pos, static_cast<S>(va_arg(ap, S)));
+        return put(buffer, size, pos, static_cast<U>(va_arg(ap, U)));
+    }
+}
+
+bool CLogFormat::next(const char* format, SConversion& conv)
+{
+    const char* p = std::strchr(format, '%');
+    if( p == NULL )
+        return false;
+
+    conv.m_pBegin = p++;
+    conv.m_Stars = 0;
+    conv.m_Length = 0;
+
+    // Flags, width and precision
+    while( *p && std::strchr("-+ #0", *p) )
+        p++;
+    for( ; *p && (std::strchr("0123456789.", *p) || *p == '*'); p++ )
+        if( *p == '*' )
+            conv.m_Stars++;
+
+    // Length modifier
+    switch( *p )
+    {
+    case 'h':
+        conv.m_Length = (p[1] == 'h') ? 'H' : 'h';
+        p += (p[1] == 'h') ? 2 : 1;
+        break;
+    case 'l':
+        conv.m_Length = (p[1] == 'l') ? 'L' : 'l';
+        p += (p[1] == 'l') ? 2 : 1;
+        break;
+    case 'L': case 'q':
+        conv.m_Length = 'L';
+        p++;
+        break;
+    case 'z': case 'j': case 't':
+        conv.m_Length = *p++;
+        break;
+    }
+
+    conv.m_Type = *p;
+    conv.m_pEnd = *p ? p + 1 : p;
+
+    return true;
+}
+
+size_t CLogFormat::pack(char* buffer, size_t size, const char* format, std::va_list ap)
+{
+    std::va_list args;
+    va_copy(args, ap);
+
+    size_t pos = 0;
+    SConversion conv;
+    bool room = true;
+    for( ; room && next(format, conv); format = conv.m_pEnd )
+    {
+        for( int i = 0; room && i < conv.m_Stars; i++ )
+            room = put(buffer, size, pos, va_arg(args, int));
+        if( ! room )
+            break;
+
+        switch( conv.m_Type )
+        {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+        {
+            bool is_signed = (conv.m_Type == 'd') || (conv.m_Type == 'i');
+            switch( conv.m_Length )
+            {
+            case 'l': room = packInteger<long, unsigned long>(buffer, size, pos, is_signed, args); break;
+            case 'L': room = packInteger<long long, unsigned long long>(buffer, size, pos, is_signed, args); break;
+            case 'z': room = packInteger<ptrdiff_t, size_t>(buffer, size, pos, is_signed, args); break;
+            case 'j': room = packInteger<intmax_t, uintmax_t>(buffer, size, pos, is_signed, args); break;
+            case 't': room = packInteger<ptrdiff_t, size_t>(buffer, size, pos, is_signed, args); break;
+            default:  room = packInteger<int, unsigned int>(buffer, size, pos, is_signed, args); break;
+            }
+            break;
+        }
+        case 'c':
+            room = put(buffer, size, pos, va_arg(args, int));
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if( conv.m_Length == 'L' )
+                room = put(buffer, size, pos, static_cast<double>(va_arg(args, long double)));
+            else
+                room = put(buffer, size, pos, va_arg(args, double));
+            break;
+        case 's':
+        {
+            const char* str = va_arg(args, const char*);
+            if( str == NULL )
+                str = "(null)";
+            if( pos + sizeof(uint16_t) > size )
+            {
+                room = false;
+                break;
+            }
+            size_t len = std::min(std::min(std::strlen(str), size - pos - sizeof(uint16_t)), static_cast<size_t>(UINT16_MAX));
+            put(buffer, size, pos, static_cast<uint16_t>(len));
+            std::memcpy(buffer + pos, str, len);
+            pos += len;
+            break;
+        }
+        case 'p':
+            room = put(buffer, size, pos, reinterpret_cast<uintptr_t>(va_arg(args, void*)));
+            break;
+        case 'n':
+            va_arg(args, void*);
+            break;
+        case '%':
+            break;
+        default:
+            // Unknown conversion - types of next arguments are unknown
+            room = false;
+        }
+    }
+
+    va_end(args);
+
+    return pos;
+}
+
+size_t CLogFormat::unpack(char* text, size_t size, const char* format, const char* args, size_t args_size)
+{
+    if( size == 0 )
+        return 0;
+
+    size_t len = 0, pos = 0;
+    char spec[64];
+    SConversion conv;
+    bool have = true;
+    for( ; have && next(format, conv); format = conv.m_pEnd )
+    {
+        appendText(text, size, len, format, conv.m_pBegin);
+
+        // Conversion spec with '*' replaced by packed values
+        size_t spec_len = 0;
+        for( const char* p = conv.m_pBegin; have && p < conv.m_pEnd && spec_len < sizeof(spec) - 12; p++ )
+        {
+            if( *p == '*' )
+            {
+                int value;
+                have = get(args, args_size, pos, value);
+                if( have )
+                    spec_len += static_cast<size_t>(std::snprintf(spec + spec_len, sizeof(spec) - spec_len, "%d", value));
+            }
+            else
+                spec[spec_len++] = *p;
+        }
+        spec[spec_len] = '\0';
+        if( ! have )
+            break;
+
+        switch( conv.m_Type )
+        {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+        {
+            bool is_signed = (conv.m_Type == 'd') || (conv.m_Type == 'i');
+            switch( conv.m_Length )
+            {
+            case 'l': have = appendInteger<long, unsigned long>(text, size, len, spec, is_signed, args, args_size, pos); break;
+            case 'L': have = appendInteger<long long, unsigned long long>(text, size, len, spec, is_signed, args, args_size, pos); break;
+            case 'z': have = appendInteger<ptrdiff_t, size_t>(text, size, len, spec, is_signed, args, args_size, pos); break;
+            case 'j': have = appendInteger<intmax_t, uintmax_t>(text, size, len, spec, is_signed, args, args_size, pos); break;
+            case 't': have = appendInteger<ptrdiff_t, size_t>(text, size, len, spec, is_signed, args, args_size, pos); break;
+            default:  have = appendInteger<int, unsigned int>(text, size, len, spec, is_signed, args, args_size, pos); break;
+            }
+            break;
+        }
+        case 'c':
+        {
+            int value;
+            if( (have = get(args, args_size, pos, value)) )
+                append(text, size, len, spec, value);
+            break;
+        }
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        {
+            double value;
+            if( (have = get(args, args_size, pos, value)) )
+            {
+                if( conv.m_Length == 'L' )
+                    append(text, size, len, spec, static_cast<long double>(value));
+                else
+                    append(text, size, len, spec, value);
+            }
+            break;
+        }
+        case 's':
+        {
+            uint16_t str_len;
+            if( (have = get(args, args_size, pos, str_len)) )
+            {
+                std::string str(args + pos, std::min(static_cast<size_t>(str_len), args_size - pos));
+                pos += str.size();
+                append(text, size, len, spec, str.c_str());
+            }
+            break;
+        }
+        case 'p':
+        {
+            uintptr_t value;
+            if( (have = get(args, args_size, pos, value)) )
+                append(text, size, len, spec, reinterpret_cast<void*>(value));
+            break;
+        }
+        case 'n':
+            break;
+        case '%':
+            appendText(text, size, len, conv.m_pEnd - 1, conv.m_pEnd);
+            break;
+        default:
+            have = false;
+        }
+    }
+
+    // Not packed rest of message is shown as format
+    if( ! have )
+        format = conv.m_pBegin;
+    appendText(text, size, len, format, format + std::strlen(format));
+    text[len] = '\0';
+
+    return len;
+}
+
+const char* CLogFormat::levelName(unsigned int level)
+{
+    static const char* levels[] = { "", "DEBUG", "INFO", "NOTICE", "WARN", "ERROR", "CRIT", "ALERT", "FATAL" };
+    return (level < sizeof(levels) / sizeof(levels[0])) ? levels[level] : "?";
+}
+
+const char* CLogFormat::subsystemName(unsigned int subsystem)
+{
+    static const char* subsystems[] = { "game", "nerv", "world", "data", "ogre" };
+    return (subsystem < sizeof(subsystems) / sizeof(subsystems[0])) ? subsystems[subsystem] : "?";
+}
+
+bool CLogFormat::writeHeader(FILE* file)
+{
+    return (std::fwrite(s_Magic, sizeof(s_Magic), 1, file) == 1)
+        && (std::fwrite(&s_Version, sizeof(s_Version), 1, file) == 1);
+}
+
+bool CLogFormat::readHeader(FILE* file)
+{
+    char magic[4];
+    uint32_t version;
+    return (std::fread(magic, sizeof(magic), 1, file) == 1)
+        && (std::memcmp(magic, s_Magic, sizeof(magic)) == 0)
+        && (std::fread(&version, sizeof(version), 1, file) == 1)
+        && (version == s_Version);
+}
+
+void CLogFormat::writeFormat(FILE* file, uint32_t id, const char* format)
+{
+    uint8_t type = RECORD_FORMAT;
+    uint16_t len = static_cast<uint16_t>(std::min(std::strlen(format), static_cast<size_t>(UINT16_MAX)));
+    std::fwrite(&type, sizeof(type), 1, file);
+    std::fwrite(&id, sizeof(id), 1, file);
+    std::fwrite(&len, sizeof(len), 1, file);
+    std::fwrite(format, 1, len, file);
+}
+
+void CLogFormat::writeMessage(FILE* file, uint32_t time, uint8_t level, uint8_t subsystem, uint32_t id, const char* args, uint16_t args_size)
+{
+    uint8_t type = RECORD_MESSAGE;
+    std::fwrite(&type, sizeof(type), 1, file);
+    std::fwrite(&time, sizeof(time), 1, file);
+    std::fwrite(&level, sizeof(level), 1, file);
+    std::fwrite(&subsystem, sizeof(subsystem), 1, file);
+    std::fwrite(&id, sizeof(id), 1, file);
+    std::fwrite(&args_size, sizeof(args_size), 1, file);
+    std::fwrite(args, 1, args_size, file);
+}
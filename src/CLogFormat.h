@@ -0,0 +1,150 @@
+/**
+ * @file    CLogFormat.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Packed log messages and binary log format
+ *
+ *
+ */
+
+#ifndef CLOGFORMAT_H
+#define CLOGFORMAT_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace Common
+{
+    /** @brief Log message without text formatting
+     *
+     *  Message is printf format (string literal) and its arguments packed
+     * by types of format conversions: integers and pointers keep their size,
+     * floats are doubles, strings are copied with 16-bit length. Text is
+     * formatted later by writer thread or by td_logdump from binary log.
+     *
+     *  Binary log is header and tagged records in host byte order:
+     * format record (id, text) is written once before first message with
+     * this format, message record has time, level, subsystem, format id and
+     * packed arguments.
+     *
+     * Header has no Common.h dependencies - it is used by td_logdump tool.
+     */
+    class CLogFormat
+    {
+    public:
+        /** @brief Binary log record tags
+         */
+        enum RecordType
+        {
+            RECORD_FORMAT  = 'F', ///< Format text: uint32 id, uint16 length, text
+            RECORD_MESSAGE = 'M'  ///< Message: uint32 time, uint8 level, uint8 subsystem, uint32 format id, uint16 size, arguments
+        };
+
+        /** @brief Pack arguments of format
+         *
+         * @param buffer - Arguments buffer
+         * @param size - Buffer size
+         * @param format - printf format
+         * @param ap - Format arguments
+         * @return size_t - Size of packed arguments
+         *
+         * Strings are truncated to fit buffer, other arguments are not packed
+         * after buffer is full.
+         */
+        static size_t pack(char* buffer, size_t size, const char* format, std::va_list ap);
+
+        /** @brief Format text from packed arguments
+         *
+         * @param text - Output buffer
+         * @param size - Output buffer size
+         * @param format - printf format used to pack arguments
+         * @param args - Packed arguments
+         * @param args_size - Size of packed arguments
+         * @return size_t - Length of text
+         */
+        static size_t unpack(char* text, size_t size, const char* format, const char* args, size_t args_size);
+
+        /** @brief Name of log level
+         *
+         * @param level
+         * @return const char*
+         */
+        static const char* levelName(unsigned int level);
+
+        /** @brief Name of log subsystem
+         *
+         * @param subsystem
+         * @return const char*
+         */
+        static const char* subsystemName(unsigned int subsystem);
+
+        /** @brief Write binary log header
+         *
+         * @param file
+         * @return bool
+         */
+        static bool writeHeader(FILE* file);
+
+        /** @brief Check binary log header
+         *
+         * @param file
+         * @return bool - false if file is not binary log of supported version
+         */
+        static bool readHeader(FILE* file);
+
+        /** @brief Write format record
+         *
+         * @param file
+         * @param id - Format id
+         * @param format - Format text
+         */
+        static void writeFormat(FILE* file, uint32_t id, const char* format);
+
+        /** @brief Write message record
+         *
+         * @param file
+         * @param time - Message time (milliseconds)
+         * @param level
+         * @param subsystem
+         * @param id - Format id
+         * @param args - Packed arguments
+         * @param args_size - Size of packed arguments
+         */
+        static void writeMessage(FILE* file, uint32_t time, uint8_t level, uint8_t subsystem, uint32_t id, const char* args, uint16_t args_size);
+
+        static const char     s_Magic[4]; ///< Binary log signature "TDLG"
+        static const uint32_t s_Version;  ///< Binary log version
+
+    private:
+        CLogFormat() {  }
+        ~CLogFormat() {  }
+
+        /** @brief Parsed printf conversion
+         */
+        struct SConversion
+        {
+            const char* m_pBegin;     ///< Position of '%'
+            const char* m_pEnd;       ///< Position after conversion character
+            int         m_Stars;      ///< Number of '*' width and precision arguments
+            char        m_Length;     ///< Length modifier: 0, 'h', 'H' (hh), 'l', 'L' (ll or L), 'z', 'j', 't'
+            char        m_Type;       ///< Conversion character
+        };
+
+        /** @brief Find next conversion in format
+         *
+         * @param format - Position in format
+         * @param conv - Found conversion
+         * @return bool - false if format has no more conversions
+         */
+        static bool next(const char* format, SConversion& conv);
+    };
+}
+
+#endif // CLOGFORMAT_H
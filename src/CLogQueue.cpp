@@ -0,0 +1,164 @@
+/**
+ * @file    CLogQueue.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Asynchronous log writer
+ *
+ *
+ */
+
+#include "CLogQueue.h"
+#include "CLogFormat.h"
+
+#include <cstdio>
+#include <chrono>
+
+using namespace Common;
+
+CLogQueue::CLogQueue(size_t records, FILE* binary)
+    : m_pRecords()
+    , m_Mask()
+    , m_Head(0)
+    , m_Tail(0)
+    , m_Dropped(0)
+    , m_ReportedDropped(0)
+    , m_Writer()
+    , m_Mutex()
+    , m_Wakeup()
+    , m_Stop(false)
+    , m_pBinary(binary)
+    , m_Formats()
+{
+    size_t size = 2;
+    while( size < records )
+        size <<= 1;
+
+    m_Mask = size - 1;
+    m_pRecords = new SRecord[size];
+    for( size_t i = 0; i < size; i++ )
+        m_pRecords[i].m_Sequence.store(i, std::memory_order_relaxed);
+
+    m_Writer = std::thread(&CLogQueue::work, this);
+}
+
+CLogQueue::~CLogQueue()
+{
+    m_Stop.store(true);
+    m_Wakeup.notify_one();
+    m_Writer.join();
+
+    delete[] m_pRecords;
+}
+
+bool CLogQueue::push(CLog::Subsystem sys, CLog::LogLevel level, unsigned long time, const char* format, std::va_list ap)
+{
+    // Take free record: its sequence equals to position when writer released it
+    size_t pos = m_Head.load(std::memory_order_relaxed);
+    SRecord* rec;
+    for( ;; )
+    {
+        rec = &m_pRecords[pos & m_Mask];
+        size_t seq = rec->m_Sequence.load(std::memory_order_acquire);
+        if( seq == pos )
+        {
+            if( m_Head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) )
+                break;
+        }
+        else if( seq < pos )
+        {
+            // Writer is one ring behind
+            m_Dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+            pos = m_Head.load(std::memory_order_relaxed);
+    }
+
+    rec->m_Subsystem = sys;
+    rec->m_Level = level;
+    rec->m_Time = time;
+    rec->m_pFormat = format;
+    rec->m_Size = static_cast<uint16_t>(CLogFormat::pack(rec->m_Args, sizeof(rec->m_Args), format, ap));
+
+    // Publish record for writer
+    rec->m_Sequence.store(pos + 1, std::memory_order_release);
+    m_Wakeup.notify_one();
+
+    return true;
+}
+
+void CLogQueue::flush()
+{
+    size_t head = m_Head.load(std::memory_order_acquire);
+    while( m_Tail.load(std::memory_order_acquire) < head )
+    {
+        m_Wakeup.notify_one();
+        std::this_thread::yield();
+    }
+}
+
+bool CLogQueue::pop()
+{
+    size_t pos = m_Tail.load(std::memory_order_relaxed);
+    SRecord& rec = m_pRecords[pos & m_Mask];
+    if( rec.m_Sequence.load(std::memory_order_acquire) != pos + 1 )
+        return false;
+
+    if( m_pBinary != NULL )
+    {
+        // Format text is written once before first message
+        std::map<const char*, uint32_t>::iterator it = m_Formats.find(rec.m_pFormat);
+        if( it == m_Formats.end() )
+        {
+            it = m_Formats.insert(std::make_pair(rec.m_pFormat, static_cast<uint32_t>(m_Formats.size()))).first;
+            CLogFormat::writeFormat(m_pBinary, it->second, rec.m_pFormat);
+        }
+        CLogFormat::writeMessage(m_pBinary, static_cast<uint32_t>(rec.m_Time), static_cast<uint8_t>(rec.m_Level),
+                                 static_cast<uint8_t>(rec.m_Subsystem), it->second, rec.m_Args, rec.m_Size);
+    }
+
+    if( CLog::s_Console || CLog::s_pFile != NULL )
+    {
+        char message[CONFIG_LOG_BUFFER];
+        CLogFormat::unpack(message, sizeof(message), rec.m_pFormat, rec.m_Args, rec.m_Size);
+        CLog::write(rec.m_Level, rec.m_Time, message);
+    }
+
+    // Release record for next ring pass
+    rec.m_Sequence.store(pos + m_Mask + 1, std::memory_order_release);
+    m_Tail.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+void CLogQueue::work()
+{
+    char message[64];
+    for( ;; )
+    {
+        while( pop() ) {}
+
+        unsigned long dropped = m_Dropped.load(std::memory_order_relaxed);
+        if( dropped != m_ReportedDropped )
+        {
+            std::snprintf(message, sizeof(message), "Log queue is full, %lu messages dropped", dropped - m_ReportedDropped);
+            CLog::write(CLog::LOG_WARN, CLog::time(), message);
+            m_ReportedDropped = dropped;
+        }
+
+        if( m_Stop.load() )
+            break;
+
+        // Producers do not lock mutex, so wakeup may be lost - sleep is limited
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Wakeup.wait_for(lock, std::chrono::milliseconds(10));
+    }
+
+    // Records pushed while stopping
+    while( pop() ) {}
+}
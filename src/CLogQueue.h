@@ -0,0 +1,129 @@
+/**
+ * @file    CLogQueue.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Asynchronous log writer
+ *
+ *
+ */
+
+#ifndef CLOGQUEUE_H
+#define CLOGQUEUE_H
+
+#include "Common.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+
+namespace Common
+{
+    /** @brief Lock-free queue of log records with background writer thread
+     *
+     *  Any thread packs message arguments (see CLogFormat) into free record
+     * of fixed size ring and publishes it without locks. Writer thread takes
+     * records in order, writes them to binary log and formats text for
+     * CLog::write(). If ring is full message is dropped and counted - logging
+     * never blocks caller.
+     */
+    class CLogQueue
+    {
+    public:
+        /** @brief Allocate ring and start writer thread
+         *
+         * @param records - Ring size, rounded up to power of two
+         * @param binary - Binary log file with written header (NULL - no binary log)
+         */
+        CLogQueue(size_t records, FILE* binary = NULL);
+
+        /** @brief Stop writer thread, queued records are written before
+         */
+        ~CLogQueue();
+
+        /** @brief Pack message into queue
+         *
+         * @param sys - Subsystem of message
+         * @param level - Level of message
+         * @param time - Message time (milliseconds)
+         * @param format - Format of message like printf, string literal
+         * @param ap - Format parameters
+         * @return bool - false if queue is full and message dropped
+         */
+        bool push(CLog::Subsystem sys, CLog::LogLevel level, unsigned long time, const char* format, std::va_list ap);
+
+        /** @brief Wait until all pushed records are written
+         */
+        void flush();
+
+        /** @brief Number of dropped messages
+         *
+         * @return unsigned long
+         */
+        inline unsigned long dropped() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+    private:
+        /** @brief Fake copy constructor
+         *
+         * @param obj
+         *
+         * @todo create copy constructor
+         */
+        CLogQueue(const CLogQueue& obj);
+        /** @brief Fake eq operator
+         *
+         * @param obj
+         *
+         * @toto create eq copy operator
+         */
+        CLogQueue& operator=(const CLogQueue& obj);
+
+        /** @brief One message in ring
+         */
+        struct SRecord
+        {
+            std::atomic<size_t> m_Sequence;  ///< Position of record in queue, says who owns record
+            CLog::Subsystem     m_Subsystem; ///< Message subsystem
+            CLog::LogLevel      m_Level;     ///< Message level
+            unsigned long       m_Time;      ///< Message time (milliseconds)
+            const char*         m_pFormat;   ///< Message format
+            uint16_t            m_Size;      ///< Size of packed arguments
+            char                m_Args[CONFIG_LOG_RECORD]; ///< Packed arguments
+        };
+
+        /** @brief Write one queued record
+         *
+         * @return bool - false if queue is empty
+         */
+        bool pop();
+
+        /** @brief Writer thread function
+         */
+        void work();
+
+        SRecord*                m_pRecords;  ///< Ring of records
+        size_t                  m_Mask;      ///< Ring size - 1
+        std::atomic<size_t>     m_Head;      ///< Next position to push
+        std::atomic<size_t>     m_Tail;      ///< Next position to write
+        std::atomic<unsigned long> m_Dropped; ///< Dropped messages
+        unsigned long           m_ReportedDropped; ///< Dropped messages at last report
+
+        std::thread             m_Writer;    ///< Writer thread
+        std::mutex              m_Mutex;     ///< Mutex of writer sleep
+        std::condition_variable m_Wakeup;    ///< Wakes writer on new records
+        std::atomic<bool>       m_Stop;      ///< Writer needs to stop
+
+        FILE*                   m_pBinary;   ///< Binary log file
+        std::map<const char*, uint32_t> m_Formats; ///< Ids of formats written to binary log
+    };
+}
+
+#endif // CLOGQUEUE_H
@@ -0,0 +1,78 @@
+/**
+ * @file    CPool.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Fixed size blocks allocator
+ *
+ *
+ */
+
+#include "CPool.h"
+
+#include <algorithm>
+
+CPool::CPool(size_t size, size_t align, uint chunk)
+    : m_Size()
+    , m_Align(std::max(align, __alignof__(SFreeBlock)))
+    , m_Chunk(std::max(chunk, 1u))
+    , m_Chunks()
+    , m_pFree(NULL)
+    , m_Used(0)
+    , m_Capacity(0)
+{
+    // Every block keeps alignment of next block in chunk
+    m_Size = (std::max(size, sizeof(SFreeBlock)) + m_Align - 1) & ~(m_Align - 1);
+}
+
+CPool::~CPool()
+{
+    if( m_Used > 0 )
+        log_warn("Pool of %lu bytes blocks is destroyed with %u blocks in use", static_cast<ulong>(m_Size), m_Used);
+
+    for( std::vector<char*>::iterator it = m_Chunks.begin(); it != m_Chunks.end(); ++it )
+        delete[] *it;
+}
+
+void* CPool::alloc()
+{
+    if( m_pFree == NULL )
+        grow();
+
+    SFreeBlock* block = m_pFree;
+    m_pFree = block->m_pNext;
+    m_Used++;
+
+    return block;
+}
+
+void CPool::release(void* block)
+{
+    SFreeBlock* free_block = static_cast<SFreeBlock*>(block);
+    free_block->m_pNext = m_pFree;
+    m_pFree = free_block;
+    m_Used--;
+}
+
+void CPool::grow()
+{
+    char* chunk = new char[m_Size * m_Chunk + m_Align];
+    m_Chunks.push_back(chunk);
+
+    // First block is aligned inside of chunk
+    size_t offset = (m_Align - reinterpret_cast<size_t>(chunk) % m_Align) % m_Align;
+    char* block = chunk + offset;
+
+    // Blocks are put in free list in reverse order to be taken in order of address
+    for( uint i = m_Chunk; i > 0; i-- )
+    {
+        SFreeBlock* free_block = reinterpret_cast<SFreeBlock*>(block + m_Size * (i - 1));
+        free_block->m_pNext = m_pFree;
+        m_pFree = free_block;
+    }
+    m_Capacity += m_Chunk;
+}
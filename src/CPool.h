@@ -0,0 +1,172 @@
+/**
+ * @file    CPool.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Fixed size blocks allocator
+ *
+ *
+ */
+
+#ifndef CPOOL_H
+#define CPOOL_H
+
+#include "Common.h"
+
+#include <new>
+#include <utility>
+
+/** @brief Arena of fixed size aligned blocks with free list
+ *
+ *  Blocks are taken from chunks, released blocks are kept in free list
+ * and reused by next allocation - allocation and release are O(1) and do
+ * not touch heap after pool is warmed up. Chunks are freed only with pool.
+ * Pool is not thread safe.
+ */
+class CPool
+{
+public:
+    /** @brief Create empty pool
+     *
+     * @param size - Size of block
+     * @param align - Alignment of block (power of two)
+     * @param chunk - Number of blocks in one chunk
+     */
+    CPool(size_t size, size_t align, uint chunk = 64);
+
+    /** @brief Free all chunks
+     *
+     * Blocks in use must be released before.
+     */
+    ~CPool();
+
+    /** @brief Get free block
+     *
+     * @return void*
+     */
+    void* alloc();
+
+    /** @brief Return block to pool
+     *
+     * @param block - Block of this pool
+     * @return void
+     */
+    void release(void* block);
+
+    /** @brief Size of block
+     *
+     * @return size_t
+     */
+    inline size_t size() const { return m_Size; }
+
+    /** @brief Alignment of block
+     *
+     * @return size_t
+     */
+    inline size_t align() const { return m_Align; }
+
+    /** @brief Number of blocks in use
+     *
+     * @return uint
+     */
+    inline uint used() const { return m_Used; }
+
+    /** @brief Number of allocated blocks
+     *
+     * @return uint
+     */
+    inline uint capacity() const { return m_Capacity; }
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CPool(const CPool& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CPool& operator=(const CPool& obj);
+
+    /** @brief Free block, placed in block memory
+     */
+    struct SFreeBlock
+    {
+        SFreeBlock*     m_pNext; ///< Next free block
+    };
+
+    /** @brief Allocate new chunk and put its blocks in free list
+     *
+     * @return void
+     */
+    void grow();
+
+    size_t                  m_Size;       ///< Size of block with alignment padding
+    size_t                  m_Align;      ///< Alignment of block
+    uint                    m_Chunk;      ///< Blocks in one chunk
+    std::vector<char*>      m_Chunks;     ///< Allocated chunks
+    SFreeBlock*             m_pFree;      ///< Head of free list
+    uint                    m_Used;       ///< Blocks in use
+    uint                    m_Capacity;   ///< Blocks in all chunks
+};
+
+/** @brief Pool of objects of one type
+ *
+ * Objects are constructed in blocks of pool and destroyed by pool.
+ */
+template<typename T>
+class CObjectPool
+    : public CPool
+{
+public:
+    /** @brief Create empty pool
+     *
+     * @param chunk - Number of objects in one chunk
+     */
+    CObjectPool(uint chunk = 64)
+        : CPool(sizeof(T), __alignof__(T), chunk)
+    {
+    }
+
+    /** @brief Construct object in pool
+     *
+     * @param args - Arguments of object constructor
+     * @return T*
+     */
+    template<typename... Args>
+    T* create(Args&&... args)
+    {
+        void* block = alloc();
+        try {
+            return new(block) T(std::forward<Args>(args)...);
+        }
+        catch( ... ) {
+            release(block);
+            throw;
+        }
+    }
+
+    /** @brief Destroy object and return its block to pool
+     *
+     * @param obj - Object of this pool or NULL
+     * @return void
+     */
+    void destroy(T* obj)
+    {
+        if( obj == NULL )
+            return;
+        obj->~T();
+        release(obj);
+    }
+};
+
+#endif // CPOOL_H
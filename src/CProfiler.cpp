@@ -0,0 +1,174 @@
+/**
+ * @file    CProfiler.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Frame profiler
+ *
+ *
+ */
+
+#include "CProfiler.h"
+
+#include <cstdio>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <limits>
+
+std::mutex CProfiler::s_Mutex;
+std::vector<CProfiler::SThreadBuffer*> CProfiler::s_Buffers;
+std::atomic<unsigned long> CProfiler::s_Frame(0);
+uint64_t CProfiler::s_FrameStart = 0;
+__thread CProfiler::SThreadBuffer* CProfiler::s_pBuffer = NULL;
+
+CProfiler::SThreadBuffer* CProfiler::buffer()
+{
+    if( s_pBuffer == NULL )
+    {
+        SThreadBuffer* buf = new SThreadBuffer();
+        buf->m_pEvents = new SEvent[CONFIG_PROFILE_EVENTS];
+        buf->m_Next = 0;
+        buf->m_Wrapped = false;
+
+        std::unique_lock<std::mutex> lock(s_Mutex);
+        buf->m_Thread = static_cast<uint>(s_Buffers.size());
+        s_Buffers.push_back(buf);
+        s_pBuffer = buf;
+    }
+
+    return s_pBuffer;
+}
+
+void CProfiler::record(const char* name, uint64_t start, uint64_t end)
+{
+    SThreadBuffer* buf = buffer();
+
+    SEvent& ev = buf->m_pEvents[buf->m_Next];
+    ev.m_pName = name;
+    ev.m_Start = start;
+    ev.m_End = end;
+    ev.m_Frame = static_cast<uint32_t>(s_Frame.load(std::memory_order_relaxed));
+
+    if( ++buf->m_Next == CONFIG_PROFILE_EVENTS )
+    {
+        buf->m_Next = 0;
+        buf->m_Wrapped = true;
+    }
+}
+
+void CProfiler::frame()
+{
+    uint64_t time = now();
+    if( s_FrameStart != 0 )
+        record("Frame", s_FrameStart, time);
+
+    s_FrameStart = time;
+    s_Frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CProfiler::report()
+{
+    std::unique_lock<std::mutex> lock(s_Mutex);
+
+    // Durations of every zone name
+    std::map<std::string, std::vector<uint64_t> > zones;
+    for( std::vector<SThreadBuffer*>::iterator it = s_Buffers.begin(); it != s_Buffers.end(); it++ )
+    {
+        size_t count = (*it)->m_Wrapped ? CONFIG_PROFILE_EVENTS : (*it)->m_Next;
+        for( size_t i = 0; i < count; i++ )
+        {
+            const SEvent& ev = (*it)->m_pEvents[i];
+            zones[ev.m_pName].push_back(ev.m_End - ev.m_Start);
+        }
+    }
+    if( zones.empty() )
+        return;
+
+    log_notice("Profile of last %u zones per thread, %lu frames (msec):", CONFIG_PROFILE_EVENTS, frames());
+    for( std::map<std::string, std::vector<uint64_t> >::iterator it = zones.begin(); it != zones.end(); it++ )
+    {
+        std::vector<uint64_t>& times = it->second;
+        std::sort(times.begin(), times.end());
+
+        uint64_t total = 0;
+        for( size_t i = 0; i < times.size(); i++ )
+            total += times[i];
+
+        log_notice("  %-24s calls %8lu  min %8.3f  avg %8.3f  p99 %8.3f  max %8.3f", it->first.c_str(),
+                   static_cast<unsigned long>(times.size()),
+                   static_cast<double>(times.front()) / 1000000.0,
+                   static_cast<double>(total) / static_cast<double>(times.size()) / 1000000.0,
+                   static_cast<double>(times[(times.size() - 1) * 99 / 100]) / 1000000.0,
+                   static_cast<double>(times.back()) / 1000000.0);
+    }
+}
+
+bool CProfiler::exportTrace(const char* path)
+{
+    std::unique_lock<std::mutex> lock(s_Mutex);
+
+    FILE* file = std::fopen(path, "w");
+    if( file == NULL )
+        return log_error("Can't create profile trace \"%s\"", path);
+
+    // Time is relative to first zone
+    uint64_t origin = std::numeric_limits<uint64_t>::max();
+    size_t events = 0;
+    for( std::vector<SThreadBuffer*>::iterator it = s_Buffers.begin(); it != s_Buffers.end(); it++ )
+    {
+        size_t count = (*it)->m_Wrapped ? CONFIG_PROFILE_EVENTS : (*it)->m_Next;
+        for( size_t i = 0; i < count; i++ )
+            origin = std::min(origin, (*it)->m_pEvents[i].m_Start);
+    }
+
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    for( std::vector<SThreadBuffer*>::iterator it = s_Buffers.begin(); it != s_Buffers.end(); it++ )
+    {
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+                     first ? "" : ",\n", (*it)->m_Thread, ((*it)->m_Thread == 0) ? "Main" : "Worker", (*it)->m_Thread);
+        first = false;
+
+        // Ring from oldest zone
+        size_t count = (*it)->m_Wrapped ? CONFIG_PROFILE_EVENTS : (*it)->m_Next;
+        size_t begin = (*it)->m_Wrapped ? (*it)->m_Next : 0;
+        for( size_t i = 0; i < count; i++ )
+        {
+            const SEvent& ev = (*it)->m_pEvents[(begin + i) % CONFIG_PROFILE_EVENTS];
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+                         ev.m_pName, (*it)->m_Thread, static_cast<double>(ev.m_Start - origin) / 1000.0,
+                         static_cast<double>(ev.m_End - ev.m_Start) / 1000.0, ev.m_Frame);
+            events++;
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    bool written = (std::fclose(file) == 0);
+    if( ! written )
+        return log_error("Can't write profile trace \"%s\"", path);
+
+    log_notice("Profile trace \"%s\": %lu zones of %lu threads", path, static_cast<unsigned long>(events),
+               static_cast<unsigned long>(s_Buffers.size()));
+
+    return true;
+}
+
+void CProfiler::clear()
+{
+    std::unique_lock<std::mutex> lock(s_Mutex);
+
+    for( std::vector<SThreadBuffer*>::iterator it = s_Buffers.begin(); it != s_Buffers.end(); it++ )
+    {
+        delete[] (*it)->m_pEvents;
+        delete *it;
+    }
+    s_Buffers.clear();
+
+    // Rings of other threads are not reachable anymore, only this thread may record again
+    s_pBuffer = NULL;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file    CProfiler.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Frame profiler
+ *
+ *
+ */
+
+#ifndef CPROFILER_H
+#define CPROFILER_H
+
+#include "Common.h"
+
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <vector>
+
+#define PROFILE_CONCAT_(a, b) a##b                ///< Helper of PROFILE_CONCAT
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT_(a, b) ///< Concatenate after macro expansion
+
+#ifdef CONFIG_PROFILE
+#   define PROFILE_ZONE(name)   CProfiler::CZone PROFILE_CONCAT(profile_zone_, __LINE__)(name) ///< Time of current scope
+#   define PROFILE_FRAME()      CProfiler::frame()                                          ///< Start of new frame
+#else
+#   define PROFILE_ZONE(name)   /* not profiled */ ///< Disabled profile zone
+#   define PROFILE_FRAME()      /* not profiled */ ///< Disabled frame mark
+#endif
+
+/** @brief Records timed zones of every thread by frames
+ *
+ *  Zone is scope with static name (string literal), its start and end
+ * time are written into ring of current thread without locks - lock is
+ * taken only once when thread records first zone. Rings keep last
+ * CONFIG_PROFILE_EVENTS zones of thread. Statistics and timeline are
+ * taken from rings when other threads do not record zones.
+ */
+class CProfiler
+{
+public:
+    /** @brief Scoped timer
+     */
+    class CZone
+    {
+    public:
+        /** @brief Start zone
+         *
+         * @param name - Static zone name
+         */
+        inline CZone(const char* name) : m_pName(name), m_Start(CProfiler::now()) {  }
+
+        /** @brief End zone and record it
+         */
+        inline ~CZone() { CProfiler::record(m_pName, m_Start, CProfiler::now()); }
+
+    private:
+        /** @brief Fake copy constructor
+         *
+         * @param obj
+         *
+         * @todo create copy constructor
+         */
+        CZone(const CZone& obj);
+        /** @brief Fake eq operator
+         *
+         * @param obj
+         *
+         * @toto create eq copy operator
+         */
+        CZone& operator=(const CZone& obj);
+
+        const char*     m_pName;  ///< Zone name
+        uint64_t        m_Start;  ///< Start time (nanoseconds)
+    };
+
+    /** @brief Current profiler time
+     *
+     * @return uint64_t - Nanoseconds
+     */
+    static inline uint64_t now() { return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch()).count()); }
+
+    /** @brief Record zone into ring of current thread
+     *
+     * @param name - Static zone name
+     * @param start - Start time (nanoseconds)
+     * @param end - End time (nanoseconds)
+     */
+    static void record(const char* name, uint64_t start, uint64_t end);
+
+    /** @brief Mark start of new frame, previous frame is recorded as "Frame" zone
+     */
+    static void frame();
+
+    /** @brief Number of marked frames
+     *
+     * @return unsigned long
+     */
+    static inline unsigned long frames() { return s_Frame.load(std::memory_order_relaxed); }
+
+    /** @brief Log min/avg/p99 time of zones kept in rings
+     */
+    static void report();
+
+    /** @brief Write kept zones as Chrome trace (chrome://tracing, Perfetto)
+     *
+     * @param path - Path to json file
+     * @return bool
+     */
+    static bool exportTrace(const char* path);
+
+    /** @brief Remove rings of all threads
+     */
+    static void clear();
+
+private:
+    CProfiler() {  }
+    ~CProfiler() {  }
+
+    /** @brief Recorded zone
+     */
+    struct SEvent
+    {
+        const char*     m_pName;  ///< Zone name
+        uint64_t        m_Start;  ///< Start time (nanoseconds)
+        uint64_t        m_End;    ///< End time (nanoseconds)
+        uint32_t        m_Frame;  ///< Frame of zone end
+    };
+
+    /** @brief Zones ring of one thread
+     */
+    struct SThreadBuffer
+    {
+        uint            m_Thread;  ///< Thread number in profiler
+        SEvent*         m_pEvents; ///< Ring of zones
+        size_t          m_Next;    ///< Next position in ring
+        bool            m_Wrapped; ///< Ring was overwritten
+    };
+
+    /** @brief Get ring of current thread, created on first use
+     *
+     * @return SThreadBuffer*
+     */
+    static SThreadBuffer* buffer();
+
+    static std::mutex                   s_Mutex;      ///< Lock of rings list
+    static std::vector<SThreadBuffer*>  s_Buffers;    ///< Rings of all threads
+    static std::atomic<unsigned long>   s_Frame;      ///< Current frame
+    static uint64_t                     s_FrameStart; ///< Start time of current frame
+    static __thread SThreadBuffer*      s_pBuffer;    ///< Ring of current thread
+};
+
+#endif // CPROFILER_H
@@ -0,0 +1,64 @@
+/**
+ * @file    CSimulationClock.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Fixed timestep simulation clock
+ *
+ *
+ */
+
+#include "CSimulationClock.h"
+
+CSimulationClock::CSimulationClock(uint rate, uint max_ticks)
+    : m_Rate()
+    , m_MaxTicks(max_ticks > 0 ? max_ticks : 1)
+    , m_Tick()
+    , m_Accumulator(0.0f)
+    , m_Ticks(0)
+    , m_Dropped(0)
+{
+    this->rate(rate);
+}
+
+CSimulationClock::~CSimulationClock()
+{
+}
+
+void CSimulationClock::rate(uint rate)
+{
+    if( rate == 0 )
+    {
+        log_warn("Bad simulation tick rate, using 120 ticks/sec");
+        rate = 120;
+    }
+
+    m_Rate = rate;
+    m_Tick = 1.0f / static_cast<Ogre::Real>(rate);
+    m_Accumulator = 0.0f;
+}
+
+uint CSimulationClock::advance(const Ogre::Real time_since_last_frame)
+{
+    if( time_since_last_frame > 0.0f )
+        m_Accumulator += time_since_last_frame;
+
+    uint ticks = static_cast<uint>(m_Accumulator / m_Tick);
+    m_Accumulator -= static_cast<Ogre::Real>(ticks) * m_Tick;
+    if( m_Accumulator < 0.0f )
+        m_Accumulator = 0.0f;
+
+    if( ticks > m_MaxTicks )
+    {
+        m_Dropped += ticks - m_MaxTicks;
+        ticks = m_MaxTicks;
+    }
+
+    m_Ticks += ticks;
+
+    return ticks;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file    CSimulationClock.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Fixed timestep simulation clock
+ *
+ *
+ */
+
+#ifndef CSIMULATIONCLOCK_H
+#define CSIMULATIONCLOCK_H
+
+#include "Common.h"
+
+/** @brief Splits variable frame time into fixed simulation ticks
+ *
+ *  Frame time is accumulated and consumed by whole ticks, remainder is
+ * used as interpolation factor between two last simulation states. Number
+ * of ticks per frame is limited - on long frames time is dropped and
+ * simulation slows down instead of spiraling.
+ */
+class CSimulationClock
+{
+public:
+    /** @brief Constructor
+     *
+     * @param rate - Ticks per second
+     * @param max_ticks - Maximum ticks per one advance
+     */
+    CSimulationClock(uint rate = 120, uint max_ticks = 8);
+
+    /** @brief Destructor
+     */
+    ~CSimulationClock();
+
+    /** @brief Set tick rate
+     *
+     * @param rate - Ticks per second
+     */
+    void rate(uint rate);
+
+    /** @brief Get tick rate
+     *
+     * @return uint
+     */
+    inline uint rate() const { return m_Rate; }
+
+    /** @brief Get tick length
+     *
+     * @return Ogre::Real - Seconds
+     */
+    inline Ogre::Real tick() const { return m_Tick; }
+
+    /** @brief Add frame time to clock
+     *
+     * @param time_since_last_frame - Seconds
+     * @return uint - Number of ticks to simulate
+     */
+    uint advance(const Ogre::Real time_since_last_frame);
+
+    /** @brief Interpolation factor between previous and current tick
+     *
+     * @return Ogre::Real - Value in [0, 1)
+     */
+    inline Ogre::Real alpha() const { return m_Accumulator / m_Tick; }
+
+    /** @brief Number of simulated ticks
+     *
+     * @return unsigned long
+     */
+    inline unsigned long ticks() const { return m_Ticks; }
+
+    /** @brief Number of ticks dropped by max ticks limit
+     *
+     * @return unsigned long
+     */
+    inline unsigned long dropped() const { return m_Dropped; }
+
+private:
+    uint                m_Rate;        ///< Ticks per second
+    uint                m_MaxTicks;    ///< Maximum ticks per advance
+    Ogre::Real          m_Tick;        ///< Tick length (seconds)
+    Ogre::Real          m_Accumulator; ///< Not simulated time (seconds)
+
+    unsigned long       m_Ticks;       ///< Simulated ticks
+    unsigned long       m_Dropped;     ///< Dropped ticks
+};
+
+#endif // CSIMULATIONCLOCK_H
@@ -0,0 +1,179 @@
+/**
+ * @file    CSlotMap.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Dense storage addressed by stable handles
+ *
+ *
+ */
+
+#ifndef CSLOTMAP_H
+#define CSLOTMAP_H
+
+#include "Common.h"
+
+/** @brief Stable handle of slot map value
+ */
+struct SSlotHandle
+{
+    uint m_Index;      ///< Slot index
+    uint m_Generation; ///< Slot generation, 0 - invalid handle
+
+    SSlotHandle() : m_Index(0), m_Generation(0) {  }
+    SSlotHandle(uint index, uint generation) : m_Index(index), m_Generation(generation) {  }
+
+    inline bool valid() const { return m_Generation != 0; }
+    inline bool operator==(const SSlotHandle& h) const { return (m_Index == h.m_Index) && (m_Generation == h.m_Generation); }
+    inline bool operator!=(const SSlotHandle& h) const { return ! (*this == h); }
+};
+
+/** @brief Values in contiguous array with O(1) add, remove and lookup by handle
+ *
+ *  Values are packed without holes (remove moves last value into freed place),
+ * so iteration goes through plain array. Handles stay valid until value is
+ * removed, removed handles are detected by slot generation.
+ */
+template<typename T>
+class CSlotMap
+{
+public:
+    typedef SSlotHandle                          Handle;   ///< Value handle
+    typedef typename std::vector<T>::iterator    iterator; ///< Dense values iterator
+
+    CSlotMap()
+        : m_Values()
+        , m_ValueSlots()
+        , m_Slots()
+        , m_FreeSlot(s_NoSlot)
+    {
+    }
+
+    /** @brief Add value
+     *
+     * @param value
+     * @return Handle
+     */
+    Handle add(const T& value)
+    {
+        uint slot;
+        if( m_FreeSlot != s_NoSlot )
+        {
+            slot = m_FreeSlot;
+            m_FreeSlot = m_Slots[slot].m_Index;
+        }
+        else
+        {
+            slot = static_cast<uint>(m_Slots.size());
+            m_Slots.push_back(SSlotHandle(0, 1));
+        }
+
+        m_Slots[slot].m_Index = static_cast<uint>(m_Values.size());
+        m_Values.push_back(value);
+        m_ValueSlots.push_back(slot);
+
+        return Handle(slot, m_Slots[slot].m_Generation);
+    }
+
+    /** @brief Remove value by handle
+     *
+     * @param handle
+     * @return bool - false if handle is not valid
+     */
+    bool remove(const Handle& handle)
+    {
+        if( ! has(handle) )
+            return false;
+
+        uint index = m_Slots[handle.m_Index].m_Index;
+        uint last = static_cast<uint>(m_Values.size()) - 1;
+
+        // Move last value into the hole
+        if( index != last )
+        {
+            m_Values[index] = m_Values[last];
+            m_ValueSlots[index] = m_ValueSlots[last];
+            m_Slots[m_ValueSlots[index]].m_Index = index;
+        }
+        m_Values.pop_back();
+        m_ValueSlots.pop_back();
+
+        // Invalidate handles and put slot in free list
+        Handle& slot = m_Slots[handle.m_Index];
+        slot.m_Generation = (slot.m_Generation + 1 != 0) ? slot.m_Generation + 1 : 1;
+        slot.m_Index = m_FreeSlot;
+        m_FreeSlot = handle.m_Index;
+
+        return true;
+    }
+
+    /** @brief Handle points to existing value
+     *
+     * @param handle
+     * @return bool
+     */
+    inline bool has(const Handle& handle) const
+    {
+        return (handle.m_Index < m_Slots.size()) && (handle.m_Generation != 0)
+            && (m_Slots[handle.m_Index].m_Generation == handle.m_Generation);
+    }
+
+    /** @brief Get value by handle
+     *
+     * @param handle
+     * @return T* - NULL if handle is not valid
+     */
+    inline T* get(const Handle& handle)
+    {
+        return has(handle) ? &m_Values[m_Slots[handle.m_Index].m_Index] : NULL;
+    }
+
+    /** @brief Get dense index of value by handle
+     *
+     * @param handle
+     * @return uint - size() if handle is not valid
+     */
+    inline uint index(const Handle& handle) const
+    {
+        return has(handle) ? m_Slots[handle.m_Index].m_Index : size();
+    }
+
+    /** @brief Get handle of value by dense index
+     *
+     * @param index - Index in [0, size())
+     * @return Handle
+     */
+    inline Handle handle(uint index) const
+    {
+        uint slot = m_ValueSlots[index];
+        return Handle(slot, m_Slots[slot].m_Generation);
+    }
+
+    /** @brief Remove all values, handles become invalid
+     */
+    void clear()
+    {
+        while( ! m_Values.empty() )
+            remove(handle(static_cast<uint>(m_Values.size()) - 1));
+    }
+
+    inline uint     size() const { return static_cast<uint>(m_Values.size()); }
+    inline bool     empty() const { return m_Values.empty(); }
+    inline iterator begin() { return m_Values.begin(); }
+    inline iterator end() { return m_Values.end(); }
+    inline T&       operator[](uint index) { return m_Values[index]; }
+
+private:
+    static const uint  s_NoSlot = 0xFFFFFFFFu; ///< End of free slots list
+
+    std::vector<T>       m_Values;     ///< Dense values
+    std::vector<uint>    m_ValueSlots; ///< Slot of every dense value
+    std::vector<Handle>  m_Slots;      ///< Dense index (or next free slot) and generation of every slot
+    uint                 m_FreeSlot;   ///< Head of free slots list
+};
+
+#endif // CSLOTMAP_H
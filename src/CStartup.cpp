@@ -0,0 +1,198 @@
+/**
+ * @file    CStartup.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Startup steps graph
+ *
+ *
+ */
+
+#include "CStartup.h"
+#include "CProfiler.h"
+
+#include <algorithm>
+
+CStartup::CStartup(uint workers)
+    : m_Steps()
+    , m_Names()
+    , m_Mutex()
+    , m_StepDone()
+    , m_Running(0)
+    , m_Start(CProfiler::now())
+    , m_Last(m_Start)
+    , m_Waited(0)
+    , m_Pool(std::max(workers, 1u))
+{
+}
+
+CStartup::~CStartup()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while( m_Running > 0 )
+        m_StepDone.wait(lock);
+}
+
+CStartup::Step CStartup::mark(const char* name)
+{
+    uint64_t now = CProfiler::now();
+    std::vector<Step> ready;
+    Step step;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        step = static_cast<Step>(m_Steps.size());
+        m_Steps.push_back(SStep(Task(), false));
+        m_Names.push_back(name);
+        m_Steps[step].m_Start = m_Last;
+        m_Steps[step].m_End = now;
+        done(step, ready);
+    }
+#ifdef CONFIG_PROFILE
+    CProfiler::record(name, m_Last, now);
+#endif
+    m_Last = now;
+
+    for( std::vector<Step>::iterator it = ready.begin(); it != ready.end(); ++it )
+        m_Pool.submit(std::bind(&CStartup::execute, this, *it));
+
+    return step;
+}
+
+CStartup::Step CStartup::async(const char* name, const Task& task, const std::vector<Step>& after)
+{
+    Step step;
+    bool ready;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        step = static_cast<Step>(m_Steps.size());
+        m_Steps.push_back(SStep(task, true));
+        m_Names.push_back(name);
+        for( std::vector<Step>::const_iterator it = after.begin(); it != after.end(); ++it )
+        {
+            SStep& dependency = m_Steps[*it];
+            if( ! dependency.m_Done )
+            {
+                dependency.m_Dependents.push_back(step);
+                m_Steps[step].m_Waiting++;
+            }
+            else if( dependency.m_Error && ! m_Steps[step].m_Error )
+                m_Steps[step].m_Error = dependency.m_Error;
+        }
+        m_Running++;
+        ready = (m_Steps[step].m_Waiting == 0);
+    }
+
+    if( ready )
+        m_Pool.submit(std::bind(&CStartup::execute, this, step));
+
+    return step;
+}
+
+void CStartup::wait(Step step)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if( ! m_Steps[step].m_Done )
+    {
+        uint64_t start = CProfiler::now();
+        while( ! m_Steps[step].m_Done )
+            m_StepDone.wait(lock);
+        uint64_t waited = CProfiler::now() - start;
+        m_Waited += waited;
+        log_debug("Startup waited for \"%s\" %.2f ms", m_Names[step], static_cast<double>(waited) / 1000000.0);
+    }
+
+    if( m_Steps[step].m_Error )
+        std::rethrow_exception(m_Steps[step].m_Error);
+}
+
+void CStartup::report()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    uint64_t end = m_Last, busy = 0;
+    for( std::vector<SStep>::const_iterator it = m_Steps.begin(); it != m_Steps.end(); ++it )
+    {
+        if( it->m_Done )
+        {
+            end = std::max(end, it->m_End);
+            busy += it->m_End - it->m_Start;
+        }
+    }
+
+    log_notice("Startup: %.2f ms, steps %.2f ms, main thread waited %.2f ms", static_cast<double>(end - m_Start) / 1000000.0
+               , static_cast<double>(busy) / 1000000.0, static_cast<double>(m_Waited) / 1000000.0);
+    for( size_t i = 0; i < m_Steps.size(); i++ )
+    {
+        const SStep& step = m_Steps[i];
+        if( ! step.m_Done )
+            log_notice("\t%-32s not done", m_Names[i]);
+        else
+            log_notice("\t%-32s %10.2f ms  at %10.2f ms  %s%s", m_Names[i], static_cast<double>(step.m_End - step.m_Start) / 1000000.0
+                       , static_cast<double>(step.m_Start - m_Start) / 1000000.0, step.m_Background ? "background" : "main"
+                       , step.m_Error ? ", failed" : "");
+    }
+}
+
+void CStartup::execute(Step step)
+{
+    Task task;
+    std::exception_ptr error;
+    uint64_t start = CProfiler::now();
+    {
+        // Task is taken, not copied: its captures may be not thread safe
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        task.swap(m_Steps[step].m_Task);
+        error = m_Steps[step].m_Error;
+        m_Steps[step].m_Start = start;
+    }
+
+    // Failed dependency fails step without execution
+    if( ! error )
+    {
+        try {
+            task();
+        }
+        catch( ... ) {
+            error = std::current_exception();
+        }
+    }
+
+    // Captures are released before waiting threads see step done
+    task = Task();
+
+    uint64_t end = CProfiler::now();
+    std::vector<Step> ready;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+#ifdef CONFIG_PROFILE
+        CProfiler::record(m_Names[step], start, end);
+#endif
+        m_Steps[step].m_End = end;
+        m_Steps[step].m_Error = error;
+        done(step, ready);
+        m_Running--;
+    }
+    m_StepDone.notify_all();
+
+    for( std::vector<Step>::iterator it = ready.begin(); it != ready.end(); ++it )
+        m_Pool.submit(std::bind(&CStartup::execute, this, *it));
+}
+
+void CStartup::done(Step step, std::vector<Step>& ready)
+{
+    SStep& current = m_Steps[step];
+    current.m_Done = true;
+
+    for( std::vector<Step>::iterator it = current.m_Dependents.begin(); it != current.m_Dependents.end(); ++it )
+    {
+        SStep& dependent = m_Steps[*it];
+        if( current.m_Error && ! dependent.m_Error )
+            dependent.m_Error = current.m_Error;
+        if( --dependent.m_Waiting == 0 )
+            ready.push_back(*it);
+    }
+    current.m_Dependents.clear();
+}
@@ -0,0 +1,139 @@
+/**
+ * @file    CStartup.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Startup steps graph
+ *
+ *
+ */
+
+#ifndef CSTARTUP_H
+#define CSTARTUP_H
+
+#include "Common.h"
+#include "CThreadPool.h"
+
+#include <cstdint>
+
+/** @brief Timed startup steps of main and background threads
+ *
+ *  Main thread marks end of its sequential steps, independent steps are
+ * executed by background threads after steps they depend on. Main thread
+ * waits for background step only where its result is needed. Background
+ * steps must not wait for other steps - use dependencies instead.
+ */
+class CStartup
+{
+public:
+    typedef CThreadPool::Task  Task; ///< Background step
+    typedef uint               Step; ///< Step number
+
+    /** @brief Start background threads
+     *
+     * @param workers - Number of background threads (at least one)
+     */
+    CStartup(uint workers);
+
+    /** @brief Wait for running steps and stop background threads
+     */
+    ~CStartup();
+
+    /** @brief Main thread step is done
+     *
+     * @param name - Static step name
+     * @return Step
+     *
+     * Step is started by end of previous main thread step.
+     */
+    Step mark(const char* name);
+
+    /** @brief Add background step
+     *
+     * @param name - Static step name
+     * @param task - Step work
+     * @param after - Steps to be done before this step
+     * @return Step
+     *
+     * Step is failed without execution if one of its dependencies is failed.
+     */
+    Step async(const char* name, const Task& task, const std::vector<Step>& after = std::vector<Step>());
+
+    /** @brief Wait until step is done
+     *
+     * @param step
+     * @return void
+     *
+     * Rethrows exception of step.
+     */
+    void wait(Step step);
+
+    /** @brief Log time of every step and waiting time of main thread
+     */
+    void report();
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CStartup(const CStartup& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CStartup& operator=(const CStartup& obj);
+
+    /** @brief Startup step state
+     */
+    struct SStep
+    {
+        SStep(const Task& task, bool background)
+            : m_Task(task), m_Dependents(), m_Waiting(0), m_Background(background)
+            , m_Done(false), m_Start(0), m_End(0), m_Error() {  }
+
+        Task                m_Task;       ///< Work of background step
+        std::vector<Step>   m_Dependents; ///< Steps waiting for this step
+        uint                m_Waiting;    ///< Number of not done dependencies
+        bool                m_Background; ///< Step is executed by background thread
+        bool                m_Done;       ///< Step is done
+        uint64_t            m_Start;      ///< Start time (nanoseconds)
+        uint64_t            m_End;        ///< End time (nanoseconds)
+        std::exception_ptr  m_Error;      ///< Exception of step or its dependency
+    };
+
+    /** @brief Execute background step and release its dependents
+     *
+     * @param step
+     */
+    void execute(Step step);
+
+    /** @brief Mark step done and collect dependents ready to execute
+     *
+     * @param step
+     * @param ready - Steps without not done dependencies
+     *
+     * Called under lock.
+     */
+    void done(Step step, std::vector<Step>& ready);
+
+    std::vector<SStep>          m_Steps;    ///< All steps
+    std::vector<const char*>    m_Names;    ///< Static names of steps
+    std::mutex                  m_Mutex;    ///< Steps lock
+    std::condition_variable     m_StepDone; ///< Signals done step
+    uint                        m_Running;  ///< Not done background steps
+    uint64_t                    m_Start;    ///< Startup start time (nanoseconds)
+    uint64_t                    m_Last;     ///< End of last main thread step (nanoseconds)
+    uint64_t                    m_Waited;   ///< Main thread waiting time (nanoseconds)
+    CThreadPool                 m_Pool;     ///< Background threads, stopped first
+};
+
+#endif // CSTARTUP_H
@@ -0,0 +1,143 @@
+/**
+ * @file    CThreadPool.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Worker threads pool
+ *
+ *
+ */
+
+#include "CThreadPool.h"
+
+CThreadPool::CThreadPool(uint workers)
+    : m_Workers()
+    , m_Tasks()
+    , m_Mutex()
+    , m_TaskReady()
+    , m_AllDone()
+    , m_Pending(0)
+    , m_Error()
+    , m_Stop(false)
+{
+    for( uint i = 0; i < workers; i++ )
+        m_Workers.push_back(std::thread(&CThreadPool::work, this));
+
+    log_info("Thread pool: %u workers", workers);
+}
+
+CThreadPool::~CThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_TaskReady.notify_all();
+
+    for( std::vector<std::thread>::iterator it = m_Workers.begin(); it != m_Workers.end(); it++ )
+        it->join();
+
+    // Without workers queue is executed here
+    while( ! m_Tasks.empty() )
+    {
+        Task task = m_Tasks.front();
+        m_Tasks.pop_front();
+        execute(task);
+    }
+}
+
+uint CThreadPool::hardwareThreads()
+{
+    uint threads = std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+void CThreadPool::submit(const Task& task)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Tasks.push_back(task);
+        m_Pending++;
+    }
+    m_TaskReady.notify_one();
+}
+
+void CThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while( m_Pending > 0 )
+    {
+        // Help workers instead of sleeping
+        if( ! m_Tasks.empty() )
+        {
+            Task task = m_Tasks.front();
+            m_Tasks.pop_front();
+            lock.unlock();
+            execute(task);
+            lock.lock();
+        }
+        else
+            m_AllDone.wait(lock);
+    }
+
+    if( m_Error )
+    {
+        std::exception_ptr error = m_Error;
+        m_Error = std::exception_ptr();
+        std::rethrow_exception(error);
+    }
+}
+
+void CThreadPool::parallel(uint count, const Range& task)
+{
+    if( (count == 1) || m_Workers.empty() )
+    {
+        for( uint i = 0; i < count; i++ )
+            task(i);
+        return;
+    }
+
+    for( uint i = 0; i < count; i++ )
+        submit(std::bind(task, i));
+    wait();
+}
+
+void CThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for( ;; )
+    {
+        while( !m_Stop && m_Tasks.empty() )
+            m_TaskReady.wait(lock);
+
+        if( m_Tasks.empty() )
+            return;
+
+        Task task = m_Tasks.front();
+        m_Tasks.pop_front();
+        lock.unlock();
+        execute(task);
+        lock.lock();
+    }
+}
+
+void CThreadPool::execute(const Task& task)
+{
+    std::exception_ptr error;
+    try {
+        task();
+    }
+    catch( ... ) {
+        error = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if( error && !m_Error )
+        m_Error = error;
+    if( --m_Pending == 0 )
+        m_AllDone.notify_all();
+}
@@ -0,0 +1,122 @@
+/**
+ * @file    CThreadPool.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Worker threads pool
+ *
+ *
+ */
+
+#ifndef CTHREADPOOL_H
+#define CTHREADPOOL_H
+
+#include "Common.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <deque>
+
+/** @brief Fixed set of worker threads executing queued tasks
+ *
+ *  Thread that waits for tasks helps workers to execute queue, so pool
+ * without workers just runs everything in caller thread. Exception of
+ * task is passed to waiting thread.
+ */
+class CThreadPool
+{
+public:
+    typedef std::function<void()>      Task;  ///< Queued task
+    typedef std::function<void(uint)>  Range; ///< Task for index of parallel loop
+
+    /** @brief Start worker threads
+     *
+     * @param workers - Number of worker threads
+     */
+    CThreadPool(uint workers);
+
+    /** @brief Stop worker threads, queued tasks are executed before
+     */
+    ~CThreadPool();
+
+    /** @brief Number of threads able to execute tasks (workers and caller)
+     *
+     * @return uint
+     */
+    inline uint threads() const { return static_cast<uint>(m_Workers.size()) + 1; }
+
+    /** @brief Add task to queue
+     *
+     * @param task
+     * @return void
+     *
+     */
+    void submit(const Task& task);
+
+    /** @brief Wait until all submitted tasks are done
+     *
+     * @return void
+     *
+     * Rethrows first exception thrown by tasks.
+     */
+    void wait();
+
+    /** @brief Execute task for every index in [0, count) and wait
+     *
+     * @param count - Number of indexes
+     * @param task - Task for one index
+     * @return void
+     *
+     */
+    void parallel(uint count, const Range& task);
+
+    /** @brief Default number of threads for this machine
+     *
+     * @return uint
+     */
+    static uint hardwareThreads();
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CThreadPool(const CThreadPool& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CThreadPool& operator=(const CThreadPool& obj);
+
+    /** @brief Worker thread loop
+     */
+    void work();
+
+    /** @brief Execute one task and mark it done
+     *
+     * @param task
+     */
+    void execute(const Task& task);
+
+    std::vector<std::thread>     m_Workers;   ///< Worker threads
+    std::deque<Task>             m_Tasks;     ///< Queued tasks
+    std::mutex                   m_Mutex;     ///< Queue lock
+    std::condition_variable      m_TaskReady; ///< Signals new task or stop
+    std::condition_variable      m_AllDone;   ///< Signals no pending tasks
+    uint                         m_Pending;   ///< Queued and running tasks
+    std::exception_ptr           m_Error;     ///< First exception of tasks
+    bool                         m_Stop;      ///< Workers need to exit
+};
+
+#endif // CTHREADPOOL_H
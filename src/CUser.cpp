@@ -12,6 +12,8 @@
  *
  */
 
+#define LOG_SUBSYSTEM Common::CLog::SYS_NERV ///< Log subsystem of file
+
 #include "CUser.h"
 
 #include "CGame.h"
@@ -28,13 +30,12 @@ CUser::CUser()
     , m_Nervs()
     , m_NervMaps()
     , m_CurrentSynapsMap()
+    , m_Route()
+    , m_RouteChanged(true)
     , m_pKernel(NULL)
 {
     // Loading default skeleton config
-    fs::path skeleton_path(CGame::getInstance()->getPrefix());
-    skeleton_path /= fs::path(CGame::getInstance()->path("root_data")) / fs::path(CGame::getInstance()->path("users"));
-    skeleton_path /= fs::path("skeleton") / fs::path("user.xml");
-    init(skeleton_path.c_str());
+    init(skeletonPath().c_str());
 }
 
 CUser::CUser(const char* data_file)
@@ -44,6 +45,8 @@ CUser::CUser(const char* data_file)
     , m_Nervs()
     , m_NervMaps()
     , m_CurrentSynapsMap()
+    , m_Route()
+    , m_RouteChanged(true)
     , m_pKernel(NULL)
 {
     init(data_file);
@@ -62,7 +65,10 @@ CUser::~CUser()
 
 void CUser::init(const char* data_file)
 {
-    loadData(data_file);
+    // Loaded user data is cached until data file is not changed
+    fs::path cache_path = cachePath(data_file);
+    if( ! loadSnapshot(cache_path.c_str()) && loadData(data_file) )
+        saveSnapshot(cache_path.c_str());
 
     pugi::xml_node user_config = m_data.child("config");
 
@@ -127,6 +133,28 @@ void CUser::init(const char* data_file)
         log_warn("Not found nerv mappings for user %s", name().c_str());
 }
 
+fs::path CUser::skeletonPath()
+{
+    fs::path skeleton_path(CGame::getInstance()->getPrefix());
+    skeleton_path /= fs::path(CGame::getInstance()->path("root_data")) / fs::path(CGame::getInstance()->path("users"));
+    skeleton_path /= fs::path("skeleton") / fs::path("user.xml");
+
+    return skeleton_path;
+}
+
+bool CUser::prepare(const char* data_file)
+{
+    CData data("User");
+    fs::path cache_path = data.cachePath(data_file);
+    if( data.loadSnapshot(cache_path.c_str()) )
+        return true;
+
+    if( ! data.loadData(data_file) )
+        return false;
+
+    return data.saveSnapshot(cache_path.c_str());
+}
+
 void CUser::update(const Ogre::Real)
 {
 }
@@ -134,22 +162,28 @@ void CUser::update(const Ogre::Real)
 void CUser::addNerv(const char* name, uint id)
 {
     log_debug("Creating nerv %s %d", name, id);
-    CGame::getInstance()->inputHandler()->addSubscribe(id, this);
+    // Without sensor (headless playback) signals come directly to user
+    if( CGame::getInstance()->inputHandler() != NULL )
+        CGame::getInstance()->inputHandler()->addSubscribe(id, this);
     m_Nervs[id] = name;
 }
 
 void CUser::delNerv(uint id)
 {
-    CGame::getInstance()->inputHandler()->delSubscribe(id);
+    if( CGame::getInstance()->inputHandler() != NULL )
+        CGame::getInstance()->inputHandler()->delSubscribe(id);
     m_Nervs.erase(id);
 }
 
 bool CUser::nervSignal(CSignal& sig)
 {
-    log_debug("USER %s: Recieved signal %d: %f", name().c_str(), sig.id(), sig.value());
-    std::pair<SynapsMap::iterator, SynapsMap::iterator> itp = m_NervMaps[m_CurrentSynapsMap.c_str()].equal_range(sig.id());
-    for( SynapsMap::iterator it = itp.first; it != itp.second; ++it )
-        it->second->route(sig);
+    if( m_RouteChanged )
+        buildRoute();
+
+    uint count;
+    CSynaps** synaps = m_Route.find(sig.id(), count);
+    for( uint i = 0; i < count; i++ )
+        synaps[i]->route(sig);
 
     return true;
 }
@@ -157,6 +191,20 @@ bool CUser::nervSignal(CSignal& sig)
 void CUser::setSynapsMapping(uint nerv_id, CSynaps* synaps)
 {
     m_NervMaps[m_CurrentSynapsMap.c_str()].insert(std::pair<uint, CSynaps*>(nerv_id, synaps));
+    m_RouteChanged = true;
+}
+
+void CUser::buildRoute()
+{
+    m_Route.clear();
+
+    SynapsMap& synapses = m_NervMaps[m_CurrentSynapsMap];
+    for( SynapsMap::iterator it = synapses.begin(); it != synapses.end(); ++it )
+        m_Route.add(it->first, it->second);
+    m_Route.build();
+
+    m_RouteChanged = false;
+    log_debug("USER %s: Route of nerv map \"%s\" built, %u synapses", name().c_str(), m_CurrentSynapsMap.c_str(), m_Route.size());
 }
 
 void CUser::kernel(CObjectKernel* kernel)
@@ -175,5 +223,11 @@ void CUser::kernel(CObjectKernel* kernel)
 
 void CUser::save()
 {
-    // @todo Realize this function
+    // Saved state is data snapshot, it may be loaded as user data file
+    fs::path save_path(CGame::getInstance()->env("HOME"));
+    save_path /= fs::path(CGame::getInstance()->path("user_data")) / fs::path("users");
+    save_path /= name() + ".tds";
+
+    if( saveSnapshot(save_path.c_str()) )
+        log_notice("User %s saved to \"%s\"", name().c_str(), save_path.c_str());
 }
@@ -21,6 +21,7 @@
 
 #include "CData.h"
 #include "CMaster.h"
+#include "Nerv/CNervTable.h"
 
 class CSynaps;
 class CSignal;
@@ -61,6 +62,22 @@ public:
      */
     void init(const char* data_file);
 
+    /** @brief Path to default skeleton data of user
+     *
+     * @return fs::path
+     */
+    static fs::path skeletonPath();
+
+    /** @brief Make cached snapshot of user data file actual
+     *
+     * @param data_file - path to user datafile
+     * @return bool
+     *
+     * Parsing and merge are done before user creation, init only restores
+     * snapshot. May be called by any thread - game data is not used.
+     */
+    static bool prepare(const char* data_file);
+
     /** @brief Updating user state
      *
      * @param time_since_last_frame
@@ -81,18 +98,18 @@ public:
      */
     void delNerv(uint id);
 
-    /** @brief Select current nerv map
+    /** @brief Current nerv map
      *
-     * @return NervMaps::iterator*
+     * @return const SynapsMap* - Read only, map is changed by setSynapsMapping()
      */
-    SynapsMap* currentSynapsMap() { return &m_NervMaps[m_CurrentSynapsMap.c_str()]; }
+    const SynapsMap* currentSynapsMap() { return &m_NervMaps[m_CurrentSynapsMap.c_str()]; }
 
     /** @brief Select or create new nerv map with specified name
      *
      * @param name - name of map
      * @return NervMaps::iterator*
      */
-    SynapsMap* currentSynapsMap(const char* name) { m_CurrentSynapsMap = name; return &m_NervMaps[name]; }
+    SynapsMap* currentSynapsMap(const char* name) { m_CurrentSynapsMap = name; m_RouteChanged = true; return &m_NervMaps[name]; }
 
     /** @brief Map nerv to action in selected nerv map
      *
@@ -105,6 +122,8 @@ public:
      *
      * @param sig - input event from human
      * @return bool
+     *
+     * Uses compiled route of current nerv map, route is rebuilt after mapping changes.
      */
     bool nervSignal(CSignal& sig);
 
@@ -125,6 +144,9 @@ public:
 
 
     /** @brief Saving user configs and state
+     *
+     * State is written as data snapshot "<user_data>/users/<name>.tds",
+     * CUser(data_file) loads it back.
      */
     void save();
 
@@ -134,6 +156,8 @@ protected:
     Nervs                              m_Nervs; ///< Subscribed events
     NervMaps                           m_NervMaps; ///< Lists with mappings of nervs to actions
     std::string                        m_CurrentSynapsMap; ///< Current selected map
+    CNervTable<CSynaps*>               m_Route; ///< Compiled current nerv map
+    bool                               m_RouteChanged; ///< Current nerv map was changed after route build
 
     CObjectKernel*                     m_pKernel; ///< User's main object in world
 
@@ -157,6 +181,10 @@ private:
      *
      */
     void init() {  }
+
+    /** @brief Compile route table from current nerv map
+     */
+    void buildRoute();
 };
 
 #endif // CUSER_H
@@ -14,9 +14,14 @@
 #include "Common.h"
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstdarg>
+#include <strings.h>
+#include <algorithm>
+#include <sstream>
 
-#include "CGame.h"
+#include "CLogQueue.h"
+#include "CLogFormat.h"
 
 #if Linux
     #include <unistd.h>
@@ -29,75 +34,146 @@
 using namespace Common;
 
 CLog::LogLevel CLog::s_DisplayLevel = CLog::LOG_NONE;
-unsigned long CLog::s_LogTime = 0;
+CLog::LogLevel CLog::s_Levels[CLog::SYS_COUNT] = { CLog::LOG_NONE, CLog::LOG_NONE, CLog::LOG_NONE, CLog::LOG_NONE, CLog::LOG_NONE };
 Ogre::Timer CLog::s_Timer;
+CLogQueue* CLog::s_pQueue = NULL;
+FILE* CLog::s_pFile = NULL;
+FILE* CLog::s_pBinaryFile = NULL;
+bool CLog::s_Console = true;
 
-bool CLog::log(CLog::LogLevel level, const char* format, ...)
+bool CLog::log(CLog::Subsystem sys, CLog::LogLevel level, const char* format, ...)
 {
-    if( level < s_DisplayLevel )
-        return level < 5;
+    if( level == CLog::LOG_NONE )
+        return true;
 
     // Message time
-    s_LogTime = s_Timer.getMilliseconds();
+    unsigned long log_time = time();
 
-    char msgbuffer[CONFIG_LOG_BUFFER];
-    char msglevel[] = "       ";
     std::va_list ap;
 
-    // Select output
-    FILE* output;
-    if( level < CLog::LOG_WARN )
-        output = stdout;
-    else
-        output = stderr;
+    if( s_pQueue != NULL )
+    {
+        va_start(ap, format);
+        bool queued = s_pQueue->push(sys, level, log_time, format, ap);
+        va_end(ap);
+
+        // Game may not live to write critical message
+        if( queued && level >= CLog::LOG_CRIT )
+            s_pQueue->flush();
 
+        // Critical message is not lost on full queue
+        if( queued || level < CLog::LOG_CRIT )
+            return level < CLog::LOG_ERROR;
+    }
+
+    char msgbuffer[CONFIG_LOG_BUFFER];
     va_start(ap, format);
     std::vsnprintf(msgbuffer, CONFIG_LOG_BUFFER, format, ap);
     va_end(ap);
 
-    // Message level
-    switch( level ){
-        case 1:
-            std::strcpy(msglevel, "DEBUG");
-            break;
-        case 2:
-            std::strcpy(msglevel, "INFO");
-            break;
-        case 3:
-            std::strcpy(msglevel, "NOTICE");
-            break;
-        case 4:
-            std::strcpy(msglevel, "WARN");
-            break;
-        case 5:
-            std::strcpy(msglevel, "ERROR");
-            break;
-        case 6:
-            std::strcpy(msglevel, "CRIT");
-            break;
-        case 7:
-            std::strcpy(msglevel, "ALERT");
-            break;
-        case 8:
-            std::strcpy(msglevel, "FATAL");
-            break;
-        case 0:
-            return true;
+    write(level, log_time, msgbuffer);
+
+    return level < CLog::LOG_ERROR;
+}
+
+void CLog::write(CLog::LogLevel level, unsigned long time, const char* message)
+{
+    // Select output
+    if( s_Console )
+        std::fprintf((level < CLog::LOG_WARN) ? stdout : stderr, "[%06lu.%03lu] %6s: %s\n", time/1000, time%1000, CLogFormat::levelName(level), message);
+
+    if( s_pFile != NULL )
+        std::fprintf(s_pFile, "[%06lu.%03lu] %6s: %s\n", time/1000, time%1000, CLogFormat::levelName(level), message);
+}
+
+bool CLog::start(size_t records, const char* file, bool console, bool binary)
+{
+    stop();
+
+    if( file != NULL && *file )
+    {
+        if( binary )
+        {
+            s_pBinaryFile = std::fopen(file, "wb");
+            if( s_pBinaryFile != NULL && ! CLogFormat::writeHeader(s_pBinaryFile) )
+            {
+                std::fclose(s_pBinaryFile);
+                s_pBinaryFile = NULL;
+            }
+        }
+        else
+            s_pFile = std::fopen(file, "a");
+
+        if( s_pFile == NULL && s_pBinaryFile == NULL )
+            log_warn("Can't open log file \"%s\"", file);
     }
+    s_Console = console;
 
-    std::fprintf(output, "[%06lu.%03lu] %6s: %s\n", s_LogTime/1000, s_LogTime%1000, msglevel, msgbuffer);
+    s_pQueue = new CLogQueue(records, s_pBinaryFile);
+    log_info("Logging by background thread, queue %lu messages%s", static_cast<unsigned long>(records),
+             (s_pBinaryFile != NULL) ? ", binary file" : "");
 
-    return level < CLog::LOG_ERROR;
+    return true;
+}
+
+void CLog::stop()
+{
+    if( s_pQueue != NULL )
+    {
+        CLogQueue* queue = s_pQueue;
+        s_pQueue = NULL;
+        unsigned long dropped = queue->dropped();
+        delete queue;
+        if( dropped > 0 )
+            log_warn("Log queue dropped %lu messages", dropped);
+    }
+
+    if( s_pFile != NULL )
+    {
+        std::fclose(s_pFile);
+        s_pFile = NULL;
+    }
+    if( s_pBinaryFile != NULL )
+    {
+        std::fclose(s_pBinaryFile);
+        s_pBinaryFile = NULL;
+    }
+    s_Console = true;
+}
+
+unsigned long CLog::dropped()
+{
+    return (s_pQueue != NULL) ? s_pQueue->dropped() : 0;
 }
 
 CLog::LogLevel CLog::displayLogLevel(CLog::LogLevel level)
 {
     if( level != CLog::LOG_NONE )
+    {
         s_DisplayLevel = level;
+        for( int sys = 0; sys < CLog::SYS_COUNT; sys++ )
+            s_Levels[sys] = std::max(s_Levels[sys], level);
+    }
 
     return s_DisplayLevel;
 }
 
+void CLog::level(CLog::Subsystem sys, CLog::LogLevel level)
+{
+    s_Levels[sys] = std::max(level, s_DisplayLevel);
+}
+
+CLog::LogLevel CLog::levelByName(const char* name)
+{
+    for( uint level = CLog::LOG_DEBUG; level <= CLog::LOG_EMERG; level++ )
+    {
+        if( strcasecmp(name, CLogFormat::levelName(level)) == 0 )
+            return static_cast<CLog::LogLevel>(level);
+    }
+
+    return CLog::LOG_NONE;
+}
+
 std::string Common::getPrefixPath()
 {
 #if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
@@ -168,6 +244,20 @@ std::string Common::getPrefixPath()
     throw EXCEPTION("Can't find binary path");
 }
 
+std::string Common::getCachePath()
+{
+    fs::path path;
+    const char* cache_home = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    if( cache_home != NULL && *cache_home )
+        path = cache_home;
+    else if( home != NULL )
+        path = fs::path(home) / ".cache";
+    path /= CONFIG_TD_NAME;
+
+    return path.string();
+}
+
 Name::NameCountMap Name::s_NameCount;
 
 std::string Name::next( const std::string& prefix )
@@ -20,6 +20,7 @@
 #include <signal.h>
 #include <exception>
 #include <iostream>
+#include <cstdio>
 
 #include <string>
 #include <vector>
@@ -41,29 +42,57 @@ namespace fs = boost::filesystem3;
 #define _(string) gettext(string) ///< Gettext define
 
 #ifdef CONFIG_DEBUG
-#   define log_debug(format, ...)   Common::CLog::log(Common::CLog::LogLevel::LOG_DEBUG, format, ##__VA_ARGS__) ///< Debug log
-#   define log_info(format, ...)    Common::CLog::log(Common::CLog::LogLevel::LOG_INFO, format, ##__VA_ARGS__)  ///< Info log
 #   define EXCEPTION(message)       Common::Exception(message, __FUNCTION__, __FILE__, __LINE__)                ///< Hard exception
 #   define ODD                      DebugDrawer::getSingleton()                                                 ///< Ogre Debug Drawer
 #else
-#   define log_debug(format, ...)   /* not logged */                         ///< Disabled Debug log
-#   define log_info(format, ...)    /* not logged */                         ///< Disabled Info log
 #   define EXCEPTION(message)       Common::Exception(message, __FUNCTION__) ///< Simple exception
 #endif
 
-#define log_notice(format, ...)  Common::CLog::log(Common::CLog::LogLevel::LOG_NOTICE, format, ##__VA_ARGS__) ///< Notice log
-#define log_warn(format, ...)    Common::CLog::log(Common::CLog::LogLevel::LOG_WARN, format, ##__VA_ARGS__)   ///< Warning log
-#define log_error(format, ...)   Common::CLog::log(Common::CLog::LogLevel::LOG_ERROR, format, ##__VA_ARGS__)  ///< Error log
-#define log_crit(format, ...)    Common::CLog::log(Common::CLog::LogLevel::LOG_CRIT, format, ##__VA_ARGS__)   ///< Critical log
-#define log_alert(format, ...)   Common::CLog::log(Common::CLog::LogLevel::LOG_ALERT, format, ##__VA_ARGS__)  ///< Alert log
-#define log_emerg(format, ...)   Common::CLog::log(Common::CLog::LogLevel::LOG_EMERG, format, ##__VA_ARGS__)  ///< Emergency log
+// Subsystem of log messages, source file may define it before includes
+#ifndef LOG_SUBSYSTEM
+#   define LOG_SUBSYSTEM Common::CLog::SYS_GAME ///< Default log subsystem
+#endif
+
+/// Log message if level is enabled for subsystem of current source file (format must be string literal)
+#define TD_LOG(level, format, ...) ( Common::CLog::enabled(LOG_SUBSYSTEM, level) \
+    ? Common::CLog::log(LOG_SUBSYSTEM, level, "" format, ##__VA_ARGS__) : Common::CLog::skip(level) )
+
+// Levels lower than CONFIG_LOG_LEVEL are not compiled
+#if CONFIG_LOG_LEVEL <= 1
+#   define log_debug(format, ...)   TD_LOG(Common::CLog::LogLevel::LOG_DEBUG, format, ##__VA_ARGS__)  ///< Debug log
+#else
+#   define log_debug(format, ...)   /* not logged */                                                 ///< Disabled Debug log
+#endif
+#if CONFIG_LOG_LEVEL <= 2
+#   define log_info(format, ...)    TD_LOG(Common::CLog::LogLevel::LOG_INFO, format, ##__VA_ARGS__)   ///< Info log
+#else
+#   define log_info(format, ...)    /* not logged */                                                 ///< Disabled Info log
+#endif
+#if CONFIG_LOG_LEVEL <= 3
+#   define log_notice(format, ...)  TD_LOG(Common::CLog::LogLevel::LOG_NOTICE, format, ##__VA_ARGS__) ///< Notice log
+#else
+#   define log_notice(format, ...)  Common::CLog::skip(Common::CLog::LogLevel::LOG_NOTICE)            ///< Disabled Notice log
+#endif
+#if CONFIG_LOG_LEVEL <= 4
+#   define log_warn(format, ...)    TD_LOG(Common::CLog::LogLevel::LOG_WARN, format, ##__VA_ARGS__)   ///< Warning log
+#else
+#   define log_warn(format, ...)    Common::CLog::skip(Common::CLog::LogLevel::LOG_WARN)              ///< Disabled Warning log
+#endif
+#define log_error(format, ...)   TD_LOG(Common::CLog::LogLevel::LOG_ERROR, format, ##__VA_ARGS__)  ///< Error log
+#define log_crit(format, ...)    TD_LOG(Common::CLog::LogLevel::LOG_CRIT, format, ##__VA_ARGS__)   ///< Critical log
+#define log_alert(format, ...)   TD_LOG(Common::CLog::LogLevel::LOG_ALERT, format, ##__VA_ARGS__)  ///< Alert log
+#define log_emerg(format, ...)   TD_LOG(Common::CLog::LogLevel::LOG_EMERG, format, ##__VA_ARGS__)  ///< Emergency log
 
 
 /** @brief Specialised and non-crossplatform functions
  */
 namespace Common
 {
+    class CLogQueue;
+
     /** @brief Logging class
+     *
+     * Until start() messages are written synchronously by calling thread.
      */
     class CLog
     {
@@ -83,15 +112,58 @@ namespace Common
             LOG_EMERG  = 8 ///< Game is unusable
         };
 
+        /** @brief Subsystems with separate runtime log levels
+         */
+        enum Subsystem
+        {
+            SYS_GAME  = 0, ///< Game and everything else
+            SYS_NERV  = 1, ///< Users input and controlling
+            SYS_WORLD = 2, ///< Worlds, objects and physics
+            SYS_DATA  = 3, ///< Xml data
+            SYS_OGRE  = 4, ///< Graphic engine and resources
+            SYS_COUNT = 5  ///< Number of subsystems
+        };
+
         /** @brief Log message
          *
+         * @param sys - Subsystem of message
          * @param level - Level of message
          * @param format - format of message like printf
          * @param ... - Message or printf format + parameters
          * @return bool - false, if level > 4
          *
+         * Use log_* macros - they check enabled() before call.
+         */
+        static bool log(Subsystem sys, LogLevel level, const char* format, ...);
+
+        /** @brief Message level is enabled for subsystem
+         *
+         * @param sys
+         * @param level
+         * @return bool
+         */
+        static inline bool enabled(Subsystem sys, LogLevel level) { return level >= s_Levels[sys]; }
+
+        /** @brief Result of not logged message
+         *
+         * @param level
+         * @return bool - Same as log() returns
+         */
+        static inline bool skip(LogLevel level) { return level < LOG_ERROR; }
+
+        /** @brief Set minimal runtime level of subsystem messages
+         *
+         * @param sys
+         * @param level
          */
-        static bool log(LogLevel level, const char* format, ...);
+        static void level(Subsystem sys, LogLevel level);
+
+        /** @brief Find level by name
+         *
+         * @param name - Level name like "debug" or "warn"
+         * @return LogLevel - LOG_NONE if name is unknown
+         */
+        static LogLevel levelByName(const char* name);
 
         /** @brief Get or set current displaying log level
          *
@@ -101,12 +173,58 @@ namespace Common
          */
         static LogLevel displayLogLevel(LogLevel level = LOG_NONE);
 
+        /** @brief Start writing messages by background thread
+         *
+         * @param records - Size of messages queue
+         * @param file - Path of log file (NULL - no file)
+         * @param console - Write messages to stdout/stderr
+         * @param binary - Log file is binary (see CLogFormat, decoded by td_logdump)
+         * @return bool
+         *
+         * Messages are queued not formatted, text is formatted by writer thread only
+         * for console and text file. Messages from LOG_CRIT level wait until written.
+         */
+        static bool start(size_t records, const char* file = NULL, bool console = true, bool binary = false);
+
+        /** @brief Write queued messages and return to synchronous logging
+         *
+         * Other threads must not log while queue is stopped.
+         */
+        static void stop();
+
+        /** @brief Number of messages dropped by full queue
+         *
+         * @return unsigned long
+         */
+        static unsigned long dropped();
+
+        /** @brief Get logging time
+         *
+         * @return unsigned long - Milliseconds since start
+         */
+        static unsigned long time() { return s_Timer.getMilliseconds(); }
+
     protected:
+        friend class CLogQueue;
+
         CLog();
         ~CLog();
+
+        /** @brief Write formatted message to outputs
+         *
+         * @param level - Level of message
+         * @param time - Message time (milliseconds)
+         * @param message
+         */
+        static void write(LogLevel level, unsigned long time, const char* message);
+
         static LogLevel      s_DisplayLevel; ///< Display messages with >= this level
-        static unsigned long s_LogTime;      ///< Last log time
+        static LogLevel      s_Levels[SYS_COUNT]; ///< Minimal enabled level of every subsystem (>= display level)
         static Ogre::Timer   s_Timer;        ///< Logging timer
+        static CLogQueue*    s_pQueue;       ///< Queue of background writer
+        static FILE*         s_pFile;        ///< Text log file
+        static FILE*         s_pBinaryFile;  ///< Binary log file
+        static bool          s_Console;      ///< Write messages to console
     };
 
     /** @brief Get prefix path from current binary path
@@ -117,6 +235,12 @@ namespace Common
      */
     std::string getPrefixPath();
 
+    /** @brief Get directory of cached files of user ($XDG_CACHE_HOME/td or $HOME/.cache/td)
+     *
+     * @return std::string
+     */
+    std::string getCachePath();
+
     /** @brief A utility class to generate unique names
      *
      * Thanx Ogre forum <http://www.ogre3d.org/forums/viewtopic.php?f=2&t=58048>
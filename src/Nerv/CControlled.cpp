@@ -13,6 +13,8 @@
  */
 
 
+#define LOG_SUBSYSTEM Common::CLog::SYS_NERV ///< Log subsystem of file
+
 #include "Nerv/CControlled.h"
 
 std::map<uint, CControlled*> CControlled::s_ControlledObjects;
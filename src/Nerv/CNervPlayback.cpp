@@ -0,0 +1,77 @@
+/**
+ * @file    CNervPlayback.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Nerv signals playback
+ *
+ *
+ */
+
+#define LOG_SUBSYSTEM Common::CLog::SYS_NERV ///< Log subsystem of file
+
+#include "Nerv/CNervPlayback.h"
+
+#include <cstring>
+
+#include "CUser.h"
+
+CNervPlayback::CNervPlayback()
+    : m_Records()
+    , m_Next(0)
+{
+}
+
+CNervPlayback::~CNervPlayback()
+{
+}
+
+bool CNervPlayback::load(const char* path, uint tick_rate)
+{
+    m_Records.clear();
+    m_Next = 0;
+
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if( ! file )
+        return log_error("Can't open nerv record file \"%s\"", path);
+
+    SNervFileHeader header;
+    if( ! file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.m_Magic, CNervRecorder::s_Magic, sizeof(header.m_Magic)) != 0 )
+        return log_error("File \"%s\" is not a nerv record", path);
+
+    if( header.m_Version != CNervRecorder::s_Version )
+        return log_error("Nerv record \"%s\" has unsupported version %u", path, header.m_Version);
+
+    if( header.m_TickRate != tick_rate )
+        log_warn("Nerv record \"%s\" was made with %u ticks/sec, simulation uses %u - timing will differ",
+                 path, header.m_TickRate, tick_rate);
+
+    SNervRecord rec;
+    while( file.read(reinterpret_cast<char*>(&rec), sizeof(rec)) )
+        m_Records.push_back(rec);
+
+    if( file.gcount() != 0 )
+        log_warn("Nerv record \"%s\" is truncated", path);
+
+    log_notice("Loaded %lu nerv signals, %lu ticks", static_cast<unsigned long>(m_Records.size()), length());
+
+    return true;
+}
+
+uint CNervPlayback::play(unsigned long tick, CUser* pUser)
+{
+    uint sent = 0;
+    for( ; m_Next < m_Records.size() && m_Records[m_Next].m_Tick <= tick; m_Next++, sent++ )
+    {
+        const SNervRecord& rec = m_Records[m_Next];
+        CSignal sig(rec.m_Id, rec.m_Value, rec.m_Sensitivity, rec.m_Limit);
+        pUser->nervSignal(sig);
+    }
+
+    return sent;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file    CNervPlayback.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Nerv signals playback
+ *
+ *
+ */
+
+#ifndef CNERVPLAYBACK_H
+#define CNERVPLAYBACK_H
+
+#include "Common.h"
+
+#include "Nerv/CNervRecorder.h"
+
+class CUser;
+
+/** @brief Source of recorded signals instead of Sensor devices
+ *
+ *  Record file is loaded completely, so playback does not read files
+ * during simulation. Signals are sent to user by simulation ticks of record.
+ */
+class CNervPlayback
+{
+public:
+    /** @brief Constructor
+     */
+    CNervPlayback();
+
+    /** @brief Destructor
+     */
+    ~CNervPlayback();
+
+    /** @brief Load record file
+     *
+     * @param path - Path to file
+     * @param tick_rate - Ticks per second of current simulation
+     * @return bool
+     */
+    bool load(const char* path, uint tick_rate);
+
+    /** @brief Send to user all signals recorded before simulation tick
+     *
+     * @param tick - Number of simulated ticks
+     * @param pUser - Receiver of signals
+     * @return uint - Number of sent signals
+     */
+    uint play(unsigned long tick, CUser* pUser);
+
+    /** @brief All signals are sent
+     *
+     * @return bool
+     */
+    inline bool finished() const { return m_Next >= m_Records.size(); }
+
+    /** @brief Tick of last recorded signal
+     *
+     * @return unsigned long
+     */
+    inline unsigned long length() const { return m_Records.empty() ? 0 : m_Records.back().m_Tick; }
+
+    /** @brief Number of loaded signals
+     *
+     * @return size_t
+     */
+    inline size_t size() const { return m_Records.size(); }
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CNervPlayback(const CNervPlayback& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CNervPlayback& operator=(const CNervPlayback& obj);
+
+    std::vector<SNervRecord> m_Records; ///< Recorded signals
+    size_t                   m_Next;    ///< Next signal to send
+};
+
+#endif // CNERVPLAYBACK_H
@@ -0,0 +1,83 @@
+/**
+ * @file    CNervRecorder.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Nerv signals recorder
+ *
+ *
+ */
+
+#define LOG_SUBSYSTEM Common::CLog::SYS_NERV ///< Log subsystem of file
+
+#include "Nerv/CNervRecorder.h"
+
+#include <cstring>
+
+#include "CSimulationClock.h"
+
+const char CNervRecorder::s_Magic[4] = { 'T', 'D', 'N', 'R' };
+const uint32_t CNervRecorder::s_Version = 1;
+
+CNervRecorder::CNervRecorder(const CSimulationClock* clock)
+    : m_pClock(clock)
+    , m_File()
+    , m_Records(0)
+{
+}
+
+CNervRecorder::~CNervRecorder()
+{
+    close();
+}
+
+bool CNervRecorder::open(const char* path)
+{
+    close();
+
+    m_File.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if( ! m_File )
+        return log_error("Can't create nerv record file \"%s\"", path);
+
+    SNervFileHeader header;
+    std::memcpy(header.m_Magic, s_Magic, sizeof(header.m_Magic));
+    header.m_Version = s_Version;
+    header.m_TickRate = m_pClock->rate();
+    m_File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    log_notice("Recording nerv signals to \"%s\"", path);
+
+    return true;
+}
+
+void CNervRecorder::close()
+{
+    if( ! m_File.is_open() )
+        return;
+
+    m_File.close();
+    if( m_File.fail() )
+        log_error("Nerv record file is not complete, %lu signals", m_Records);
+    else
+        log_notice("Recorded %lu nerv signals", m_Records);
+}
+
+void CNervRecorder::record(const CSignal& sig, unsigned long tick)
+{
+    if( ! m_File.is_open() )
+        return;
+
+    SNervRecord rec;
+    rec.m_Tick = static_cast<uint32_t>(tick);
+    rec.m_Id = sig.id();
+    rec.m_Value = sig.raw();
+    rec.m_Sensitivity = sig.sensitivity();
+    rec.m_Limit = sig.limit();
+    m_File.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+
+    m_Records++;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file    CNervRecorder.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Nerv signals recorder
+ *
+ *
+ */
+
+#ifndef CNERVRECORDER_H
+#define CNERVRECORDER_H
+
+#include "Common.h"
+
+#include <cstdint>
+#include <fstream>
+
+#include "Nerv/CSignal.h"
+
+class CSimulationClock;
+
+/** @brief Header of nerv record file
+ *
+ * File is header and array of SNervRecord in host byte order.
+ */
+struct SNervFileHeader
+{
+    char                m_Magic[4];  ///< File signature "TDNR"
+    uint32_t            m_Version;   ///< Format version
+    uint32_t            m_TickRate;  ///< Simulation ticks per second of recorded session
+};
+
+/** @brief One recorded signal
+ */
+struct SNervRecord
+{
+    uint32_t            m_Tick;        ///< Simulation tick when signal was received
+    uint32_t            m_Id;          ///< Signal id
+    float               m_Value;       ///< Raw value
+    float               m_Sensitivity; ///< Sensitivity
+    float               m_Limit;       ///< Minimal non-zero value
+};
+
+/** @brief Writes signals from Sensor with simulation tick stamps
+ *
+ *  Signal is stamped by number of simulation ticks done before it, so
+ * playback delivers it to the same fixed tick of simulation.
+ */
+class CNervRecorder
+{
+public:
+    /** @brief Constructor
+     *
+     * @param clock - Simulation clock, its tick rate is written to record
+     */
+    CNervRecorder(const CSimulationClock* clock);
+
+    /** @brief Destructor
+     */
+    ~CNervRecorder();
+
+    /** @brief Create record file
+     *
+     * @param path - Path to file
+     * @return bool
+     */
+    bool open(const char* path);
+
+    /** @brief Flush and close record file
+     */
+    void close();
+
+    /** @brief Write signal to record file
+     *
+     * @param sig
+     * @param tick - Number of simulated ticks before signal delivery
+     */
+    void record(const CSignal& sig, unsigned long tick);
+
+    /** @brief Number of recorded signals
+     *
+     * @return unsigned long
+     */
+    inline unsigned long size() const { return m_Records; }
+
+    static const char     s_Magic[4]; ///< File signature
+    static const uint32_t s_Version;  ///< Current format version
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CNervRecorder(const CNervRecorder& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CNervRecorder& operator=(const CNervRecorder& obj);
+
+    const CSimulationClock* m_pClock;   ///< Simulation clock
+    std::ofstream           m_File;     ///< Record file
+    unsigned long           m_Records;  ///< Recorded signals
+};
+
+#endif // CNERVRECORDER_H
@@ -0,0 +1,169 @@
+/**
+ * @file    CNervTable.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Compiled signal routing table
+ *
+ *
+ */
+
+#ifndef CNERVTABLE_H
+#define CNERVTABLE_H
+
+#include "Common.h"
+
+#include <algorithm>
+
+/** @brief Flat table from signal id to contiguous span of values
+ *
+ *  Signal id is built by device, device number and button
+ * (device * 10000 + number * 1000 + button), so table is split to blocks of
+ * 1000 buttons for every device and number. Lookup is two array reads.
+ * Values are added and removed in source list, table is compiled by
+ * build() only when mapping changes.
+ */
+template<typename T>
+class CNervTable
+{
+public:
+    CNervTable()
+        : m_Entries()
+        , m_Blocks()
+        , m_Spans()
+        , m_Values()
+    {
+    }
+
+    /** @brief Add value for signal id, table needs rebuild
+     *
+     * @param id - Signal id
+     * @param value
+     */
+    void add(uint id, const T& value) { m_Entries.push_back(std::make_pair(id, value)); }
+
+    /** @brief Remove all values of signal id, table needs rebuild
+     *
+     * @param id - Signal id
+     */
+    void remove(uint id)
+    {
+        m_Entries.erase(std::remove_if(m_Entries.begin(), m_Entries.end(), SIdEquals(id)), m_Entries.end());
+    }
+
+    /** @brief Remove all values
+     */
+    void clear()
+    {
+        m_Entries.clear();
+        build();
+    }
+
+    /** @brief Compile routing table from added values
+     *
+     * Values of one id keep order of adding.
+     */
+    void build()
+    {
+        std::stable_sort(m_Entries.begin(), m_Entries.end(), SIdLess());
+
+        m_Blocks.clear();
+        m_Spans.clear();
+        m_Values.clear();
+        m_Values.reserve(m_Entries.size());
+
+        // Blocks size by max button of every block
+        for( typename std::vector<Entry>::iterator it = m_Entries.begin(); it != m_Entries.end(); it++ )
+        {
+            uint block = it->first / s_BlockSize;
+            if( block >= m_Blocks.size() )
+                m_Blocks.resize(block + 1, SSpan());
+            m_Blocks[block].m_Count = std::max(m_Blocks[block].m_Count, it->first % s_BlockSize + 1);
+        }
+        for( typename std::vector<SSpan>::iterator it = m_Blocks.begin(); it != m_Blocks.end(); it++ )
+        {
+            it->m_First = static_cast<uint>(m_Spans.size());
+            m_Spans.resize(m_Spans.size() + it->m_Count, SSpan());
+        }
+
+        // Entries are sorted - spans of values are contiguous
+        for( typename std::vector<Entry>::iterator it = m_Entries.begin(); it != m_Entries.end(); it++ )
+        {
+            SSpan& span = m_Spans[m_Blocks[it->first / s_BlockSize].m_First + it->first % s_BlockSize];
+            if( span.m_Count == 0 )
+                span.m_First = static_cast<uint>(m_Values.size());
+            span.m_Count++;
+            m_Values.push_back(it->second);
+        }
+    }
+
+    /** @brief Find values of signal id
+     *
+     * @param id - Signal id
+     * @param count - Number of found values
+     * @return T* - First value or NULL
+     */
+    inline T* find(uint id, uint& count)
+    {
+        uint block = id / s_BlockSize;
+        uint button = id % s_BlockSize;
+        if( (block >= m_Blocks.size()) || (button >= m_Blocks[block].m_Count) )
+        {
+            count = 0;
+            return NULL;
+        }
+
+        const SSpan& span = m_Spans[m_Blocks[block].m_First + button];
+        count = span.m_Count;
+        return (count > 0) ? &m_Values[span.m_First] : NULL;
+    }
+
+    /** @brief Number of values
+     *
+     * @return uint
+     */
+    inline uint size() const { return static_cast<uint>(m_Entries.size()); }
+
+private:
+    typedef std::pair<uint, T> Entry; ///< Signal id and value
+
+    /** @brief Part of array
+     */
+    struct SSpan
+    {
+        uint m_First; ///< First index
+        uint m_Count; ///< Number of items
+
+        SSpan() : m_First(0), m_Count(0) {  }
+    };
+
+    /** @brief Sort entries by signal id
+     */
+    struct SIdLess
+    {
+        bool operator()(const Entry& a, const Entry& b) const { return a.first < b.first; }
+    };
+
+    /** @brief Entry has signal id
+     */
+    struct SIdEquals
+    {
+        uint m_Id; ///< Signal id
+
+        SIdEquals(uint id) : m_Id(id) {  }
+        bool operator()(const Entry& e) const { return e.first == m_Id; }
+    };
+
+    static const uint   s_BlockSize = 1000u; ///< Buttons of one device number
+
+    std::vector<Entry>  m_Entries; ///< Source values
+    std::vector<SSpan>  m_Blocks;  ///< Spans of buttons for device and number
+    std::vector<SSpan>  m_Spans;   ///< Spans of values for every button
+    std::vector<T>      m_Values;  ///< Values grouped by signal id
+};
+
+#endif // CNERVTABLE_H
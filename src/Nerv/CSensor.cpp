@@ -12,7 +12,11 @@
  *
  */
 
+#define LOG_SUBSYSTEM Common::CLog::SYS_NERV ///< Log subsystem of file
+
 #include "Nerv/CSensor.h"
+#include "Nerv/CNervRecorder.h"
+#include "CFrameScheduler.h"
 
 #include <string>
 
@@ -23,8 +27,16 @@ CSensor::CSensor(size_t windowHnd)
     , m_pJoyStick()
     , m_JoysticsNum()
     , m_pGame(CGame::getInstance())
-    , m_subscribedUsers()
-    , m_CleanMouse(-1)
+    , m_Subscribers()
+    , m_pRecorder()
+    , m_pQueue()
+    , m_Capture()
+    , m_Stop(false)
+    , m_Period(0)
+    , m_Tick(0)
+    , m_Stamp(0)
+    , m_WindowSize(0)
+    , m_Axes()
     , m_LastMouseX(0)
     , m_LastMouseY(0)
     , m_LastMouseZ(0)
@@ -92,17 +104,38 @@ CSensor::CSensor(size_t windowHnd)
         log_warn("Exception raised on joystick creation: %s", ex.eText);
     }
 
-    // Preparing subscribers map
-    std::map<uint, CUser*> nullmap;
-    m_subscribedUsers[OIS::OISKeyboard] = nullmap;
-    m_subscribedUsers[OIS::OISMouse] = nullmap;
-    m_subscribedUsers[OIS::OISJoyStick] = nullmap;
+    // Capture rate is independent of frame rate
+    pugi::xml_node input_config = m_pGame->config("input");
+    uint rate = 1000, queue = 4096;
+    if( *input_config.child_value("rate") )
+        rate = Ogre::StringConverter::parseUnsignedInt(input_config.child_value("rate"), rate);
+    if( *input_config.child_value("queue") )
+        queue = Ogre::StringConverter::parseUnsignedInt(input_config.child_value("queue"), queue);
+
+    m_pQueue = new CSignalQueue(queue);
+    if( rate > 0 )
+    {
+        m_Period = 1000000ul / std::min(rate, 1000000u);
+        m_Capture = std::thread(&CSensor::work, this);
+        log_info("\tCapture thread: %u captures/sec", rate);
+    }
+    else
+        log_info("\tDevices are captured every frame");
 }
 
 CSensor::~CSensor()
 {
     log_debug("Destroying Nerv sensor");
 
+    if( m_Capture.joinable() )
+    {
+        m_Stop.store(true);
+        m_Capture.join();
+    }
+    if( m_pQueue->dropped() > 0 )
+        log_warn("Dropped %lu input signals on full queue", m_pQueue->dropped());
+    delete m_pQueue;
+
     m_pInputManager->destroyInputObject(m_pMouse);
     m_pInputManager->destroyInputObject(m_pKeyboard);
     if( m_JoysticsNum > 0 )
@@ -111,35 +144,38 @@ CSensor::~CSensor()
             m_pInputManager->destroyInputObject(m_pJoyStick[i]);
     }
 
-    for( auto it = m_subscribedUsers.begin(); it != m_subscribedUsers.end(); it++ )
-    {
-        for( auto itu = it->second.begin(); itu != it->second.end(); itu++ )
-            log_debug("Found subscribe id#%d", itu->first);
-    }
+    log_debug("Found %u subscribes", m_Subscribers.size());
 
     OIS::InputManager::destroyInputSystem(m_pInputManager);
 
     log_debug("Complete destroying Nerv sensor");
 }
 
-void CSensor::capture()
+void CSensor::capture(unsigned long time)
 {
-    // Capture keyboard
-    m_pKeyboard->capture();
+    if( m_Period == 0 )
+    {
+        m_Stamp = time;
+        captureDevices();
+    }
+}
+
+void CSensor::windowSize(uint width, uint height)
+{
+    m_WindowSize.store((static_cast<uint64_t>(width) << 32) | height);
+}
 
-    // Clean move and capture of mouse
-    if( m_CleanMouse >= 0 )
+void CSensor::captureDevices()
+{
+    uint64_t size = m_WindowSize.exchange(0);
+    if( size != 0 )
     {
-        m_CleanMouse = m_CleanMouse - 1;
-        if( m_CleanMouse == -1 )
-        {
-            log_debug("Cleaning mouse move %d", m_CleanMouse);
-            OIS::MouseState mouse_state = m_pMouse->getMouseState();
-            mouse_state.clear();
-            OIS::MouseEvent mouse_event(m_pMouse, mouse_state);
-            mouseMoved(mouse_event);
-        }
+        const OIS::MouseState& ms = m_pMouse->getMouseState();
+        ms.width = static_cast<int>(size >> 32);
+        ms.height = static_cast<int>(size & 0xffffffff);
     }
+
+    m_pKeyboard->capture();
     m_pMouse->capture();
 
     // Capture joystics
@@ -150,6 +186,78 @@ void CSensor::capture()
     }
 }
 
+void CSensor::work()
+{
+    unsigned long next = m_pGame->microtime();
+    while( ! m_Stop.load() )
+    {
+        captureDevices();
+
+        // Late capture does not cause a burst of captures
+        next += m_Period;
+        unsigned long now = m_pGame->microtime();
+        if( next > now )
+            CFrameScheduler::sleep(next - now);
+        else
+            next = now;
+    }
+}
+
+void CSensor::push(const CSignal& sig)
+{
+    m_pQueue->push(sig, (m_Period == 0) ? m_Stamp : m_pGame->microtime());
+}
+
+uint CSensor::dispatch(unsigned long time, unsigned long tick)
+{
+    m_Tick = tick;
+
+    // Raw mouse moves have ids of device 0 axes, joystick axes - of device 2
+    const uint mouse_move = genId(OIS::OISMouse, 0, 0);
+    const uint joystick_axis = genId(OIS::OISJoyStick, 2, 0);
+    const uint key = genId(OIS::OISKeyboard, 0, 0);
+
+    int move[3] = { 0, 0, 0 };
+    m_Axes.clear();
+
+    uint count = 0;
+    const SStampedSignal* rec;
+    while( ((rec = m_pQueue->front()) != NULL) && (rec->m_Time <= time) )
+    {
+        CSignal sig = rec->m_Signal;
+        m_pQueue->pop();
+        count++;
+
+        uint id = sig.id();
+        if( (id >= mouse_move) && (id < mouse_move + 3) )
+            move[id - mouse_move] += static_cast<int>(sig.raw());
+        else if( (id >= joystick_axis) && (id < joystick_axis + 16) )
+        {
+            std::vector<CSignal>::iterator it = m_Axes.begin();
+            while( (it != m_Axes.end()) && (it->id() != id) )
+                ++it;
+            if( it != m_Axes.end() )
+                *it = sig;
+            else
+                m_Axes.push_back(sig);
+        }
+        else
+        {
+            send(sig);
+            if( (id >= key) && (id < key + 1000) && (sig.raw() > 0.0f) )
+                gameKey(static_cast<int>(id - key));
+        }
+    }
+
+    // Tick without moves stops mouse
+    sendMouseMove(move[0], move[1], move[2]);
+
+    for( std::vector<CSignal>::iterator it = m_Axes.begin(); it != m_Axes.end(); ++it )
+        send(*it);
+
+    return count;
+}
+
 OIS::Mouse* CSensor::getMouse()
 {
     return m_pMouse;
@@ -170,17 +278,30 @@ OIS::JoyStick* CSensor::getJoyStick(int joyId)
     return NULL;
 }
 
+void CSensor::send(CSignal& sig)
+{
+    if( m_pRecorder != NULL )
+        m_pRecorder->record(sig, m_Tick);
+
+    uint count;
+    CUser** user = m_Subscribers.find(sig.id(), count);
+    if( user != NULL )
+        (*user)->nervSignal(sig);
+}
+
 bool CSensor::keyPressed( const OIS::KeyEvent& arg )
 {
     // Converting keyboard keypress to nerv Signal
     CSignal sig(genId(OIS::OISKeyboard, 0, arg.key), 1.0);
 
-    SigUser::iterator user = m_subscribedUsers[OIS::OISKeyboard].find(sig.id());
-    if( user != m_subscribedUsers[OIS::OISKeyboard].end() )
-        user->second->nervSignal(sig);
+    push(sig);
 
-    // @todo Move control of game to CGame object Actions
-    if( arg.key == OIS::KC_T )
+    return true;
+}
+
+void CSensor::gameKey(int key)
+{
+    if( key == OIS::KC_T )
     {
         // Cycle filter rendering mode
         Ogre::FilterOptions ft = Ogre::MaterialManager::getSingleton().getDefaultTextureFiltering(Ogre::FT_MIN);
@@ -205,7 +326,7 @@ bool CSensor::keyPressed( const OIS::KeyEvent& arg )
         Ogre::MaterialManager::getSingleton().setDefaultTextureFiltering(tfo);
         Ogre::MaterialManager::getSingleton().setDefaultAnisotropy(aniso);
     }
-    else if( arg.key == OIS::KC_R )
+    else if( key == OIS::KC_R )
     {
         // Cycle polygon rendering mode
         Ogre::PolygonMode pm;
@@ -224,17 +345,15 @@ bool CSensor::keyPressed( const OIS::KeyEvent& arg )
 
         m_pGame->m_pCamera->setPolygonMode(pm);
     }
-    else if( arg.key == OIS::KC_F5 )
+    else if( key == OIS::KC_F5 )
     {
         // Refresh all textures
         Ogre::TextureManager::getSingleton().reloadAll();
     }
-    else if( arg.key == OIS::KC_Q )
+    else if( key == OIS::KC_Q )
     {
         m_pGame->exit();
     }
-
-    return true;
 }
 
 bool CSensor::keyReleased( const OIS::KeyEvent& arg )
@@ -242,74 +361,74 @@ bool CSensor::keyReleased( const OIS::KeyEvent& arg )
     // Converting keyboard keyrelease to nerv Signal
     CSignal sig(genId(OIS::OISKeyboard, 0, arg.key), 0.0);
 
-    SigUser::iterator user = m_subscribedUsers[OIS::OISKeyboard].find(sig.id());
-    if( user != m_subscribedUsers[OIS::OISKeyboard].end() )
-        user->second->nervSignal(sig);
+    push(sig);
 
     return true;
 }
 
 bool CSensor::mouseMoved( const OIS::MouseEvent& arg )
 {
-    // @todo Fix left-right and up-down
-    if( arg.state.X.rel || arg.state.Y.rel || arg.state.Z.rel )
-        m_CleanMouse = 2;
+    // Raw relative moves, converted to sensor signals by dispatch()
+    if( arg.state.X.rel )
+        push(CSignal(genId(OIS::OISMouse, 0, 0), static_cast<float>(arg.state.X.rel)));
+    if( arg.state.Y.rel )
+        push(CSignal(genId(OIS::OISMouse, 0, 1), static_cast<float>(arg.state.Y.rel)));
+    if( arg.state.Z.rel )
+        push(CSignal(genId(OIS::OISMouse, 0, 2), static_cast<float>(arg.state.Z.rel)));
 
+    return true;
+}
+
+void CSensor::sendMouseMove(int x, int y, int z)
+{
+    // @todo Fix left-right and up-down
     CSignal sig;
 
     // Converting mouse move into nerv Signal
-    if( arg.state.X.rel != m_LastMouseX )
+    if( x != m_LastMouseX )
     {
-        if( arg.state.X.rel < 0 )
-            sig = CSignal(genId(OIS::OISMouse, 0, SENS_LEFT), static_cast<float>(-arg.state.X.rel), 0.05f);
-        else if( arg.state.X.rel > 0 )
-            sig = CSignal(genId(OIS::OISMouse, 0, SENS_RIGHT), static_cast<float>(arg.state.X.rel), 0.05f);
+        if( x < 0 )
+            sig = CSignal(genId(OIS::OISMouse, 0, SENS_LEFT), static_cast<float>(-x), 0.05f);
+        else if( x > 0 )
+            sig = CSignal(genId(OIS::OISMouse, 0, SENS_RIGHT), static_cast<float>(x), 0.05f);
         else
             sig = CSignal(genId(OIS::OISMouse, 0, (m_LastMouseX < 0) ? SENS_LEFT : SENS_RIGHT),
-                          static_cast<float>(arg.state.X.rel), 0.05f);
+                          static_cast<float>(x), 0.05f);
 
-        SigUser::iterator user = m_subscribedUsers[OIS::OISMouse].find(sig.id());
-        if( user != m_subscribedUsers[OIS::OISMouse].end() )
-            user->second->nervSignal(sig);
+        send(sig);
 
-        m_LastMouseX = arg.state.X.rel;
+        m_LastMouseX = x;
     }
 
-    if( arg.state.Y.rel != m_LastMouseY )
+    if( y != m_LastMouseY )
     {
-        if( arg.state.Y.rel < 0 )
-            sig = CSignal(genId(OIS::OISMouse, 0, SENS_UP), static_cast<float>(-arg.state.Y.rel), 0.05f);
-        else if( arg.state.Y.rel > 0 )
-            sig = CSignal(genId(OIS::OISMouse, 0, SENS_DOWN), static_cast<float>(arg.state.Y.rel), 0.05f);
+        if( y < 0 )
+            sig = CSignal(genId(OIS::OISMouse, 0, SENS_UP), static_cast<float>(-y), 0.05f);
+        else if( y > 0 )
+            sig = CSignal(genId(OIS::OISMouse, 0, SENS_DOWN), static_cast<float>(y), 0.05f);
         else
             sig = CSignal(genId(OIS::OISMouse, 0, (m_LastMouseY < 0) ? SENS_UP : SENS_DOWN),
-                          static_cast<float>(arg.state.Z.rel), 0.05f);
+                          static_cast<float>(y), 0.05f);
 
-        SigUser::iterator user = m_subscribedUsers[OIS::OISMouse].find(sig.id());
-        if( user != m_subscribedUsers[OIS::OISMouse].end() )
-            user->second->nervSignal(sig);
+        send(sig);
 
-        m_LastMouseY = arg.state.Y.rel;
+        m_LastMouseY = y;
     }
 
-    if( arg.state.Z.rel != m_LastMouseZ )
+    if( z != m_LastMouseZ )
     {
-        if( arg.state.Z.rel < 0 )
-            sig = CSignal(genId(OIS::OISMouse, 0, SENS_IMMERSION), static_cast<float>(-arg.state.Z.rel), 0.004166f);
-        else if( arg.state.Z.rel > 0 )
-            sig = CSignal(genId(OIS::OISMouse, 0, SENS_EMERSION), static_cast<float>(arg.state.Z.rel), 0.004166f);
+        if( z < 0 )
+            sig = CSignal(genId(OIS::OISMouse, 0, SENS_IMMERSION), static_cast<float>(-z), 0.004166f);
+        else if( z > 0 )
+            sig = CSignal(genId(OIS::OISMouse, 0, SENS_EMERSION), static_cast<float>(z), 0.004166f);
         else
             sig = CSignal(genId(OIS::OISMouse, 0, (m_LastMouseZ < 0) ? SENS_IMMERSION : SENS_EMERSION),
-                          static_cast<float>(arg.state.Z.rel), 0.05f);
+                          static_cast<float>(z), 0.05f);
 
-        SigUser::iterator user = m_subscribedUsers[OIS::OISMouse].find(sig.id());
-        if( user != m_subscribedUsers[OIS::OISMouse].end() )
-            user->second->nervSignal(sig);
+        send(sig);
 
-        m_LastMouseZ = arg.state.Z.rel;
+        m_LastMouseZ = z;
     }
-
-    return true;
 }
 
 bool CSensor::mousePressed( const OIS::MouseEvent&, OIS::MouseButtonID button )
@@ -317,9 +436,7 @@ bool CSensor::mousePressed( const OIS::MouseEvent&, OIS::MouseButtonID button )
     // Converting mouse button press to nerv Signal
     CSignal sig(genId(OIS::OISMouse, 1, button), 1.0);
 
-    SigUser::iterator user = m_subscribedUsers[OIS::OISMouse].find(sig.id());
-    if( user != m_subscribedUsers[OIS::OISMouse].end() )
-        user->second->nervSignal(sig);
+    push(sig);
 
     return true;
 }
@@ -329,9 +446,7 @@ bool CSensor::mouseReleased( const OIS::MouseEvent&, OIS::MouseButtonID button )
     // Converting mouse button release to nerv Signal
     CSignal sig(genId(OIS::OISMouse, 1, button), 0.0);
 
-    SigUser::iterator user = m_subscribedUsers[OIS::OISMouse].find(sig.id());
-    if( user != m_subscribedUsers[OIS::OISMouse].end() )
-        user->second->nervSignal(sig);
+    push(sig);
 
     return true;
 }
@@ -360,9 +475,7 @@ bool CSensor::povMoved( const OIS::JoyStickEvent& arg, int pov )
 
     if( sig.id() != 0 )
     {
-        SigUser::iterator user = m_subscribedUsers[OIS::OISJoyStick].find(sig.id());
-        if( user != m_subscribedUsers[OIS::OISJoyStick].end() )
-            user->second->nervSignal(sig);
+        push(sig);
     }
 
     // Y axis
@@ -384,9 +497,7 @@ bool CSensor::povMoved( const OIS::JoyStickEvent& arg, int pov )
 
     if( sig.id() != 0 )
     {
-        SigUser::iterator user = m_subscribedUsers[OIS::OISJoyStick].find(sig.id());
-        if( user != m_subscribedUsers[OIS::OISJoyStick].end() )
-            user->second->nervSignal(sig);
+        push(sig);
     }
 
     return true;
@@ -398,24 +509,18 @@ bool CSensor::buttonPressed( const OIS::JoyStickEvent&, int button )
     // Converting joystick button press to nerv Signal
     CSignal sig(genId(OIS::OISJoyStick, 1, button), 1.0);
 
-    SigUser::iterator user = m_subscribedUsers[OIS::OISJoyStick].find(sig.id());
-    if( user != m_subscribedUsers[OIS::OISJoyStick].end() )
-        user->second->nervSignal(sig);
+    push(sig);
 
     return true;
 }
 
-bool CSensor::buttonReleased( const OIS::JoyStickEvent& arg, int button )
+bool CSensor::buttonReleased( const OIS::JoyStickEvent&, int button )
 {
     // @todo Realize many joysticks
-    log_debug("Joystick \"%s\" button #%d released", arg.device->vendor().c_str(), button);
-
     // Converting joystick button release to nerv Signal
     CSignal sig(genId(OIS::OISJoyStick, 1, button), 0.0);
 
-    SigUser::iterator user = m_subscribedUsers[OIS::OISJoyStick].find(sig.id());
-    if( user != m_subscribedUsers[OIS::OISJoyStick].end() )
-        user->second->nervSignal(sig);
+    push(sig);
 
     return true;
 }
@@ -430,8 +535,6 @@ bool CSensor::axisMoved( const OIS::JoyStickEvent& arg, int axis )
     int direct = axis * 2;
     int opp_direct = axis % 2;
 
-    log_debug("Value %d pos %d", value, direct);
-
     if( opp_direct )
     {
         // Inverse Up-Down axis
@@ -481,21 +584,16 @@ bool CSensor::axisMoved( const OIS::JoyStickEvent& arg, int axis )
 
     if( sig.id() != 0 )
     {
-        SigUser::iterator user = m_subscribedUsers[OIS::OISJoyStick].find(sig.id());
-        if( user != m_subscribedUsers[OIS::OISJoyStick].end() )
-            user->second->nervSignal(sig);
+        push(sig);
     }
 
     // Nulling opposite direction
     if( m_ChangedAxis[opp_direct] == true )
     {
-        log_debug("Nulling %d", opp_direct);
         m_ChangedAxis[opp_direct] = false;
         sig = CSignal(genId(OIS::OISJoyStick, 2, opp_direct), 0.0);
 
-        SigUser::iterator user = m_subscribedUsers[OIS::OISJoyStick].find(sig.id());
-        if( user != m_subscribedUsers[OIS::OISJoyStick].end() )
-            user->second->nervSignal(sig);
+        push(sig);
     }
 
     return true;
@@ -504,19 +602,22 @@ bool CSensor::axisMoved( const OIS::JoyStickEvent& arg, int axis )
 bool CSensor::addSubscribe(uint id, CUser* pUser)
 {
     uint device = id / 10000u;
+    if( device >= sizeof(m_DeviceType) / sizeof(m_DeviceType[0]) )
+        return log_error("Bad device of signal id#%u", id);
 
     log_debug("Subscribing user \"%s\" to %s signal id#%u", pUser->name().c_str(), m_DeviceType[device].c_str(), id);
 
-    m_subscribedUsers[static_cast<OIS::Type>(device)][id] = pUser;
+    m_Subscribers.remove(id);
+    m_Subscribers.add(id, pUser);
+    m_Subscribers.build();
 
     return true;
 }
 
 bool CSensor::delSubscribe(uint id)
 {
-    // @todo add recognize type of device by id
-    OIS::Type device = OIS::OISKeyboard;
-    m_subscribedUsers[device].erase(id);
+    m_Subscribers.remove(id);
+    m_Subscribers.build();
 
     return true;
 }
@@ -19,13 +19,24 @@
 
 #include <OIS/OISForceFeedback.h>
 
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
 #include "CGame.h"
 #include "Nerv/CSignal.h"
+#include "Nerv/CSignalQueue.h"
+#include "Nerv/CNervTable.h"
 
-typedef std::map<uint, CUser*> SigUser; ///< Signal->User map
-typedef std::map<OIS::Type, SigUser > SubUsers; ///< Device->SigUser map - maybe no-need...
+class CNervRecorder;
 
 /** @brief Global input handler from user and routed it in need user
+ *
+ *  Devices are captured by own thread with configured rate (input/rate),
+ * device callbacks only push captured signals with time stamps to queue.
+ * Simulation takes signals by dispatch() before every tick and sends them
+ * to subscribed users, so delivery does not depend on frame time. Mouse
+ * moves and joystick axes are coalesced per tick.
  */
 class CSensor : public OIS::KeyListener, public OIS::MouseListener, public OIS::JoyStickListener
 {
@@ -34,10 +45,11 @@ public:
      *
      * @param windowHnd
      *
+     * Capture thread is started if input/rate of config is not 0.
      */
     CSensor(size_t windowHnd);
 
-    /** @brief Destructor
+    /** @brief Destructor, stops capture thread
      */
     ~CSensor();
 
@@ -50,12 +62,35 @@ public:
         SENS_EMERSION  = 5  ///< Z Down
     };
 
-    /** @brief Capture of events in mouse, keyboard or joystics
+    /** @brief Capture of events in mouse, keyboard or joystics by caller thread
+     *
+     * @param time - Time of last simulated tick end, stamp of captured signals
+     * @return void
+     *
+     * Does nothing if devices are captured by capture thread.
+     */
+    void capture(unsigned long time);
+
+    /** @brief Set window size of mouse state
      *
+     * @param width - Window width
+     * @param height - Window height
      * @return void
      *
+     * Size is applied to mouse state before next capture of devices.
+     */
+    void windowSize(uint width, uint height);
+
+    /** @brief Send to users signals captured before time
+     *
+     * @param time - Time of simulation tick end (microseconds of game timer)
+     * @param tick - Number of simulated ticks, stamp of recorded signals
+     * @return uint - Number of taken signals
+     *
+     * Mouse moves are summed and joystick axes take last value, a tick
+     * without mouse moves stops mouse. Called by main thread only.
      */
-    void capture();
+    uint dispatch(unsigned long time, unsigned long tick);
 
 
     /** @brief Get connected mouse device
@@ -93,6 +128,12 @@ public:
      */
     bool delSubscribe(uint id);
 
+    /** @brief Set recorder of all sended signals
+     *
+     * @param pRecorder - NULL to stop recording
+     */
+    inline void recorder(CNervRecorder* pRecorder) { m_pRecorder = pRecorder; }
+
 protected:
     /** @brief Function on keyboard key pressed event
      *
@@ -183,7 +224,8 @@ protected:
 
     CGame*             m_pGame; ///< Link to game
 
-    SubUsers           m_subscribedUsers; ///< Map of subscribed Users to need signals. DeviceType->EventType->UserLink
+    CNervTable<CUser*> m_Subscribers; ///< Subscribed user of every signal id
+    CNervRecorder*     m_pRecorder; ///< Signals recorder
 
 private:
     /** @brief Fake copy constructor
@@ -203,9 +245,62 @@ private:
 
     inline uint genId(OIS::Type dev, int dev_number, int button){ return static_cast<uint>(dev) * 10000u + static_cast<uint>(dev_number) * 1000u + static_cast<uint>(button); }
 
+    /** @brief Record signal and send it to subscribed user
+     *
+     * @param sig
+     */
+    void send(CSignal& sig);
+
+    /** @brief Stamp captured signal and add it to queue
+     *
+     * @param sig
+     */
+    void push(const CSignal& sig);
+
+    /** @brief Capture all devices, device callbacks are called
+     *
+     * @return void
+     *
+     * New window size is applied to mouse state before capture.
+     */
+    void captureDevices();
+
+    /** @brief Capture thread function
+     *
+     * @return void
+     */
+    void work();
+
+    /** @brief Convert mouse move of tick into sensor signals and send them
+     *
+     * @param x - Relative move X
+     * @param y - Relative move Y
+     * @param z - Relative move Z
+     * @return void
+     */
+    void sendMouseMove(int x, int y, int z);
+
+    /** @brief Game control by pressed key
+     *
+     * @param key - Key code
+     * @return void
+     *
+     * @todo Move control of game to CGame object Actions
+     */
+    void gameKey(int key);
+
     std::string        m_DeviceType[6]; ///< Device types
 
-    int m_CleanMouse; ///< Frames to clean mouse device move
+    CSignalQueue*      m_pQueue;  ///< Captured signals
+    std::thread        m_Capture; ///< Capture thread
+    std::atomic<bool>  m_Stop;    ///< Capture thread needs to stop
+    unsigned long      m_Period;  ///< Capture period (microseconds), 0 - captured by caller of capture()
+    unsigned long      m_Tick;    ///< Simulation tick of dispatched signals
+    unsigned long      m_Stamp;   ///< Time stamp of signals captured by capture()
+    std::atomic<uint64_t> m_WindowSize; ///< New window width and height for mouse state, 0 - not changed
+
+    std::vector<CSignal> m_Axes;  ///< Joystick axes signals of dispatched tick
+
     int m_LastMouseX; ///< Last mouse move X
     int m_LastMouseY; ///< Last mouse move Y
     int m_LastMouseZ; ///< Last mouse move Z
@@ -46,14 +46,20 @@ public:
      * @return uint
      *
      */
-    inline uint id() { return m_Id; }
+    inline uint id() const { return m_Id; }
 
     /** @brief Get Value of event
      *
      * @return float
      *
      */
-    inline float value() { return (m_Limit > m_Value) ? 0.0f : std::min(m_Value * m_Sensitivity, 1.0f); }
+    inline float value() const { return (m_Limit > m_Value) ? 0.0f : std::min(m_Value * m_Sensitivity, 1.0f); }
+
+    /** @brief Get value of event as it was received from device
+     *
+     * @return float - Value without sensitivity and limit applied
+     */
+    inline float raw() const { return m_Value; }
 
     /** @brief Set coefficient of sensitivity
      *
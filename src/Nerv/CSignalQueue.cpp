@@ -0,0 +1,69 @@
+/**
+ * @file    CSignalQueue.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Lock-free queue of captured signals
+ *
+ *
+ */
+
+#include "Nerv/CSignalQueue.h"
+
+CSignalQueue::CSignalQueue(size_t size)
+    : m_pSignals()
+    , m_Mask()
+    , m_Head(0)
+    , m_Tail(0)
+    , m_Dropped(0)
+{
+    size_t ring = 2;
+    while( ring < size )
+        ring <<= 1;
+
+    m_Mask = ring - 1;
+    m_pSignals = new SStampedSignal[ring];
+}
+
+CSignalQueue::~CSignalQueue()
+{
+    delete[] m_pSignals;
+}
+
+bool CSignalQueue::push(const CSignal& sig, unsigned long time)
+{
+    size_t head = m_Head.load(std::memory_order_relaxed);
+    if( head - m_Tail.load(std::memory_order_acquire) > m_Mask )
+    {
+        m_Dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    SStampedSignal& rec = m_pSignals[head & m_Mask];
+    rec.m_Time = time;
+    rec.m_Signal = sig;
+
+    // Publish signal for consumer
+    m_Head.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+const SStampedSignal* CSignalQueue::front() const
+{
+    size_t tail = m_Tail.load(std::memory_order_relaxed);
+    if( tail == m_Head.load(std::memory_order_acquire) )
+        return NULL;
+
+    return &m_pSignals[tail & m_Mask];
+}
+
+void CSignalQueue::pop()
+{
+    // Record is free for producer
+    m_Tail.store(m_Tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
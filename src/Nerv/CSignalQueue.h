@@ -0,0 +1,101 @@
+/**
+ * @file    CSignalQueue.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Lock-free queue of captured signals
+ *
+ *
+ */
+
+#ifndef CSIGNALQUEUE_H
+#define CSIGNALQUEUE_H
+
+#include "Common.h"
+
+#include <atomic>
+
+#include "Nerv/CSignal.h"
+
+/** @brief Signal with capture time
+ */
+struct SStampedSignal
+{
+    unsigned long       m_Time;   ///< Capture time (microseconds of game timer)
+    CSignal             m_Signal; ///< Signal
+
+    SStampedSignal() : m_Time(0), m_Signal() {}
+};
+
+/** @brief Ring of signals from one producer thread to one consumer thread
+ *
+ *  Producer (sensor capture thread) and consumer (simulation) do not lock.
+ * If ring is full signal is dropped and counted - capture never blocks.
+ */
+class CSignalQueue
+{
+public:
+    /** @brief Allocate ring
+     *
+     * @param size - Ring size, rounded up to power of two
+     */
+    CSignalQueue(size_t size);
+
+    /** @brief Destructor
+     */
+    ~CSignalQueue();
+
+    /** @brief Add signal, called by producer
+     *
+     * @param sig - Signal
+     * @param time - Capture time (microseconds)
+     * @return bool - false if queue is full and signal dropped
+     */
+    bool push(const CSignal& sig, unsigned long time);
+
+    /** @brief Oldest signal, called by consumer
+     *
+     * @return const SStampedSignal* - NULL if queue is empty
+     */
+    const SStampedSignal* front() const;
+
+    /** @brief Remove oldest signal, called by consumer after front()
+     *
+     * @return void
+     */
+    void pop();
+
+    /** @brief Number of dropped signals
+     *
+     * @return unsigned long
+     */
+    inline unsigned long dropped() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CSignalQueue(const CSignalQueue& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CSignalQueue& operator=(const CSignalQueue& obj);
+
+    SStampedSignal*            m_pSignals; ///< Ring of signals
+    size_t                     m_Mask;     ///< Ring size - 1
+    std::atomic<size_t>        m_Head;     ///< Next position to push
+    std::atomic<size_t>        m_Tail;     ///< Next position to pop
+    std::atomic<unsigned long> m_Dropped;  ///< Dropped signals
+};
+
+#endif // CSIGNALQUEUE_H
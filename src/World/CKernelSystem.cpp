@@ -0,0 +1,206 @@
+/**
+ * @file    CKernelSystem.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Batched update of kernels
+ *
+ *
+ */
+
+#define LOG_SUBSYSTEM Common::CLog::SYS_WORLD ///< Log subsystem of file
+
+#include "World/CKernelSystem.h"
+#include "World/CWorld.h"
+#include "CGame.h"
+#include "CProfiler.h"
+
+#include <algorithm>
+
+CKernelSystem::CKernelSystem(CWorld* pWorld)
+    : m_pWorld(pWorld)
+    , m_Kernels()
+    , m_Bodies()
+    , m_GravityHandles()
+    , m_Gravity()
+    , m_Direction()
+    , m_ActMove()
+    , m_Velocity()
+    , m_SpeedMax()
+    , m_Front(Ogre::Vector3::UNIT_Z)
+    , m_FrontRotation(Ogre::Quaternion::IDENTITY)
+{
+}
+
+CKernelSystem::~CKernelSystem()
+{
+    if( ! m_Kernels.empty() )
+        log_warn("Kernel system is destroyed with %u kernels", m_Kernels.size());
+}
+
+CKernelSystem::Handle CKernelSystem::add(CObjectKernel* pKernel, btRigidBody* pBody, const SSlotHandle& gravity, Ogre::Real speed_max)
+{
+    m_Bodies.push_back(pBody);
+    m_GravityHandles.push_back(gravity);
+    m_Gravity.push_back(Ogre::Vector3::ZERO);
+    m_Direction.push_back(Ogre::Quaternion::IDENTITY);
+    m_ActMove.push_back(Ogre::Vector3::ZERO);
+    m_Velocity.push_back(Ogre::Vector3::ZERO);
+    m_SpeedMax.push_back(speed_max);
+
+    return m_Kernels.add(pKernel);
+}
+
+void CKernelSystem::remove(const Handle& kernel)
+{
+    uint index = m_Kernels.index(kernel);
+    if( index >= m_Kernels.size() )
+    {
+        log_error("Not found kernel #%u", kernel.m_Index);
+        return;
+    }
+
+    // Components are moved the same way as slot map moves kernel objects
+    uint last = m_Kernels.size() - 1;
+    if( index != last )
+    {
+        m_Bodies[index] = m_Bodies[last];
+        m_GravityHandles[index] = m_GravityHandles[last];
+        m_Gravity[index] = m_Gravity[last];
+        m_Direction[index] = m_Direction[last];
+        m_ActMove[index] = m_ActMove[last];
+        m_Velocity[index] = m_Velocity[last];
+        m_SpeedMax[index] = m_SpeedMax[last];
+    }
+    m_Bodies.pop_back();
+    m_GravityHandles.pop_back();
+    m_Gravity.pop_back();
+    m_Direction.pop_back();
+    m_ActMove.pop_back();
+    m_Velocity.pop_back();
+    m_SpeedMax.pop_back();
+
+    m_Kernels.remove(kernel);
+}
+
+Ogre::Vector3* CKernelSystem::actMove(const Handle& kernel)
+{
+    uint index = m_Kernels.index(kernel);
+    return index < m_Kernels.size() ? &m_ActMove[index] : NULL;
+}
+
+Ogre::Vector3* CKernelSystem::velocity(const Handle& kernel)
+{
+    uint index = m_Kernels.index(kernel);
+    return index < m_Kernels.size() ? &m_Velocity[index] : NULL;
+}
+
+void CKernelSystem::update(const Ogre::Real tick, const Ogre::Vector3& front, CThreadPool* pPool)
+{
+    PROFILE_ZONE("CKernelSystem::update");
+
+    // Look direction is the same for all kernels
+    m_Front = front.normalisedCopy();
+    m_FrontRotation = Ogre::Vector3::UNIT_Z.getRotationTo(m_Front);
+
+    uint count = m_Kernels.size();
+    if( (pPool == NULL) || (count <= s_Batch) )
+    {
+        updateRange(tick, 0, count);
+        return;
+    }
+
+    // Batches touch only own kernels, their bodies and gravity states
+    pPool->parallel((count + s_Batch - 1) / s_Batch, [this, tick, count](uint batch) {
+        updateRange(tick, batch * s_Batch, std::min(count, (batch + 1) * s_Batch));
+    });
+}
+
+void CKernelSystem::updateRange(const Ogre::Real tick, uint begin, uint end)
+{
+    CGravityField* field = m_pWorld->m_pGravityField;
+    const Ogre::Real speed_min = std::numeric_limits<Ogre::Real>::epsilon();
+
+    for( uint i = begin; i < end; i++ )
+    {
+        // Update gravity
+        btVector3 new_gravity = field->getObjectGravity(m_GravityHandles[i]);
+        Ogre::Vector3 gravity = BtOgre::Convert::toOgre(new_gravity);
+        if( m_Gravity[i] != gravity )
+        {
+            m_Gravity[i] = gravity;
+            m_Bodies[i]->setGravity(new_gravity);
+        }
+
+        m_Direction[i] = Ogre::Vector3::NEGATIVE_UNIT_Y.getRotationTo(gravity) * m_FrontRotation;
+
+        Ogre::Vector3 move = m_Direction[i] * m_ActMove[i];
+        Ogre::Vector3& velocity = m_Velocity[i];
+        Ogre::Real speed_max = m_SpeedMax[i];
+
+        if( ! move.isZeroLength() )
+        {
+            m_Bodies[i]->activate();
+            velocity += move.normalisedCopy() * speed_max * tick * 10;
+        }
+        else
+            velocity -= velocity * tick * 10;
+
+        // Processing action state
+        if( velocity.squaredLength() > (speed_max * speed_max) )
+        {
+            velocity.normalise();
+            velocity *= speed_max;
+        }
+        else if( velocity.squaredLength() < (speed_min * speed_min) )
+            velocity = Ogre::Vector3::ZERO;
+
+        if( move.length() > 1.0 )
+            velocity *= move.normalisedCopy().length();
+        else
+            velocity *= move.length();
+
+        // Set rotation
+        m_Bodies[i]->setAngularVelocity(BtOgre::Convert::toBullet(velocity.crossProduct(gravity.normalisedCopy())));
+    }
+}
+
+void CKernelSystem::draw()
+{
+#ifdef CONFIG_DEBUG
+    // Direction vector
+    if( ! m_Kernels.empty() )
+        ODD.drawLine(Ogre::Vector3::ZERO, m_Front * 10.0f, Ogre::ColourValue(1.0f, 0.0f, 1.0f));
+
+    for( uint i = 0; i < m_Kernels.size(); i++ )
+    {
+        // Nothing to draw in headless mode
+        Ogre::Entity* entity = m_Kernels[i]->entity();
+        if( entity == NULL )
+            continue;
+
+        Ogre::SceneNode* node = m_Kernels[i]->node();
+        const Ogre::Vector3& position = node->getPosition();
+        Ogre::Real radius = entity->getBoundingRadius();
+
+        // Direction vector
+        ODD.drawLine(position, (m_Direction[i] * Ogre::Vector3::UNIT_Z)*10.0f + position, Ogre::ColourValue(0.0f, 1.0f, 1.0f));
+        // Gravity vector (Down)
+        ODD.drawLine(position, (m_Direction[i] * Ogre::Vector3::UNIT_Y)*10.0f + position, Ogre::ColourValue(0.5f, 0.5f, 0.5f));
+        // Right vector (Down)
+        ODD.drawLine(position, (m_Direction[i] * Ogre::Vector3::NEGATIVE_UNIT_X)*10.0f + position, Ogre::ColourValue(1.0f, 1.0f, 0.0f));
+        // ActMove vector
+        ODD.drawLine(position + radius, m_ActMove[i]*10.0f + radius + position, Ogre::ColourValue::Green);
+        // Velocity vector
+        ODD.drawLine(position + radius, m_Velocity[i]*10.0f + radius + position, Ogre::ColourValue::Blue);
+        // Bounding box
+        Ogre::AxisAlignedBox cube = entity->getBoundingBox();
+        cube.transform(node->_getFullTransform());
+        ODD.drawCuboid(cube.getAllCorners(), Ogre::ColourValue::Red, true);
+    }
+#endif
+}
@@ -0,0 +1,147 @@
+/**
+ * @file    CKernelSystem.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Batched update of kernels
+ *
+ *
+ */
+
+#ifndef CKERNELSYSTEM_H
+#define CKERNELSYSTEM_H
+
+#include "Common.h"
+
+#include <OGRE/Ogre.h>
+
+#include "btogre/BtOgrePG.h"
+
+#include "CSlotMap.h"
+#include "CThreadPool.h"
+
+class CWorld;
+class CObjectKernel;
+
+/** @brief Movement state of all kernels of world in component arrays
+ *
+ *  Every component (gravity, direction, action input, velocity) is kept
+ * in its own contiguous array, kernel is index in arrays. Arrays are
+ * packed - removed kernel is replaced by last one. Update touches only
+ * arrays, rigid body and gravity state of every kernel, so ranges of
+ * kernels can be updated by different threads.
+ */
+class CKernelSystem
+{
+public:
+    typedef SSlotHandle Handle; ///< Handle of kernel
+
+    /** @brief Create empty system
+     *
+     * @param pWorld - World of kernels
+     */
+    CKernelSystem(CWorld* pWorld);
+
+    /** @brief Destructor
+     */
+    ~CKernelSystem();
+
+    /** @brief Add kernel
+     *
+     * @param pKernel - Kernel object
+     * @param pBody - Rigid body of kernel
+     * @param gravity - Gravity state of kernel in world gravity field
+     * @param speed_max - Maximum speed
+     * @return Handle
+     */
+    Handle add(CObjectKernel* pKernel, btRigidBody* pBody, const SSlotHandle& gravity, Ogre::Real speed_max);
+
+    /** @brief Remove kernel
+     *
+     * @param kernel - Handle of kernel
+     * @return void
+     */
+    void remove(const Handle& kernel);
+
+    /** @brief Action move of kernel
+     *
+     * @param kernel - Handle of kernel
+     * @return Ogre::Vector3* - NULL if handle is not valid
+     */
+    Ogre::Vector3* actMove(const Handle& kernel);
+
+    /** @brief Current velocity of kernel
+     *
+     * @param kernel - Handle of kernel
+     * @return Ogre::Vector3* - NULL if handle is not valid
+     */
+    Ogre::Vector3* velocity(const Handle& kernel);
+
+    /** @brief Update all kernels after simulation tick
+     *
+     * @param tick - Tick length in seconds
+     * @param front - Look direction of camera
+     * @param pPool - Threads for batches of kernels, NULL - update in caller thread
+     * @return void
+     *
+     * Gravity field contacts must be caught before.
+     */
+    void update(const Ogre::Real tick, const Ogre::Vector3& front, CThreadPool* pPool = NULL);
+
+    /** @brief Draw debug vectors of kernels
+     *
+     * @return void
+     */
+    void draw();
+
+    /** @brief Number of kernels
+     *
+     * @return uint
+     */
+    inline uint size() const { return m_Kernels.size(); }
+
+    static const uint s_Batch = 512; ///< Kernels in one parallel batch
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CKernelSystem(const CKernelSystem& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CKernelSystem& operator=(const CKernelSystem& obj);
+
+    /** @brief Update range of kernels
+     *
+     * @param tick - Tick length in seconds
+     * @param begin - First kernel index
+     * @param end - Index after last kernel
+     * @return void
+     */
+    void updateRange(const Ogre::Real tick, uint begin, uint end);
+
+    CWorld*                         m_pWorld;         ///< World of kernels
+    CSlotMap<CObjectKernel*>        m_Kernels;        ///< Kernel objects, index of kernel in arrays
+    std::vector<btRigidBody*>       m_Bodies;         ///< Rigid bodies
+    std::vector<SSlotHandle>        m_GravityHandles; ///< Gravity states in world gravity field
+    std::vector<Ogre::Vector3>      m_Gravity;        ///< Last gravity vectors
+    std::vector<Ogre::Quaternion>   m_Direction;      ///< Current rotation states
+    std::vector<Ogre::Vector3>      m_ActMove;        ///< Action move
+    std::vector<Ogre::Vector3>      m_Velocity;       ///< Current velocity
+    std::vector<Ogre::Real>         m_SpeedMax;       ///< Maximum speed
+    Ogre::Vector3                   m_Front;          ///< Look direction of last update
+    Ogre::Quaternion                m_FrontRotation;  ///< Rotation from Z axis to look direction
+};
+
+#endif // CKERNELSYSTEM_H
@@ -13,6 +13,8 @@
  */
 
 
+#define LOG_SUBSYSTEM Common::CLog::SYS_WORLD ///< Log subsystem of file
+
 #include "CObject.h"
 #include "CGame.h"
 
@@ -21,7 +23,6 @@ CObject::CObject(const char* name, CWorld& pWorld, const Ogre::Vector3& pos, con
     , m_pNode()
     , m_HasChild(false)
     , m_Childrens()
-    , m_itChildrens()
     , m_pParent()
     , m_pGame(CGame::getInstance())
     , m_pWorld(&pWorld)
@@ -31,21 +32,44 @@ CObject::CObject(const char* name, CWorld& pWorld, const Ogre::Vector3& pos, con
     , m_pShape()
     , m_Mass(mass)
     , m_pState()
+    , m_GravityHandle()
+    , m_pPool()
+    , m_ChildIndex(0)
 {
 }
 
 CObject::~CObject()
 {
     clearChildrens();
+    destroyBody();
+    destroyMesh();
     m_pParent = NULL;
 }
 
+void CObject::destroy(CObject* pObject)
+{
+    CPool* pool = pObject->m_pPool;
+    if( pool == NULL )
+    {
+        delete pObject;
+        return;
+    }
+
+    // Object may be not first base of allocated type
+    void* block = dynamic_cast<void*>(pObject);
+    pObject->~CObject();
+    pool->release(block);
+}
+
 void CObject::clearChildrens()
 {
-    m_itChildrens = m_Childrens.begin();
-    for( ; m_itChildrens != m_Childrens.end(); m_itChildrens++ )
-        delete *m_itChildrens;
-    m_Childrens.clear();
+    // Childrens are destroyed in reverse order of creation
+    while( ! m_Childrens.empty() )
+    {
+        CObject* child = m_Childrens.back();
+        m_Childrens.pop_back();
+        destroy(child);
+    }
     m_HasChild = false;
 }
 
@@ -53,11 +77,106 @@ void CObject::attachChild(CObject* pChild)
 {
     pChild->setParent(this);
     pChild->init();
+    pChild->m_ChildIndex = static_cast<uint>(m_Childrens.size());
     m_Childrens.push_back(pChild);
     m_HasChild = true;
 }
 
+void CObject::removeChild(CObject* pChild)
+{
+    uint index = pChild->m_ChildIndex;
+    if( (index >= m_Childrens.size()) || (m_Childrens[index] != pChild) )
+    {
+        log_error("Object \"%s\" is not child of \"%s\"", pChild->name().c_str(), name().c_str());
+        return;
+    }
+
+    m_Childrens[index] = m_Childrens.back();
+    m_Childrens[index]->m_ChildIndex = index;
+    m_Childrens.pop_back();
+    m_HasChild = ! m_Childrens.empty();
+
+    destroy(pChild);
+}
+
 std::vector<CObject*>* CObject::getChildrens()
 {
     return &m_Childrens;
 }
+
+void CObject::createMesh(const char* mesh)
+{
+    m_pNode = m_pParent->node()->createChildSceneNode(m_Position);
+
+    // Without render system entity can't load materials
+    if( ! m_pGame->headless() )
+    {
+        m_pEntity = m_pGame->m_pSceneMgr->createEntity(mesh);
+        m_pNode->attachObject(m_pEntity);
+    }
+}
+
+void CObject::createBody(short group, short mask)
+{
+    btVector3 inertia(0.0f, 0.0f, 0.0f);
+    if( m_Mass != 0.0f )
+        m_pShape->calculateLocalInertia(m_Mass, inertia);
+
+    //Create BtOgre MotionState (connects Ogre and Bullet).
+    m_pState = m_pWorld->m_States.create(m_pNode);
+
+    //Create the Body.
+    m_pBody = m_pWorld->m_Bodies.create(m_Mass, m_pState, m_pShape, inertia);
+    m_pBody->setUserPointer(this);
+    m_pWorld->m_pPhyWorld->addRigidBody(m_pBody, group, mask);
+}
+
+void CObject::destroyBody()
+{
+    if( m_pBody != NULL )
+    {
+        m_pWorld->m_pPhyWorld->removeRigidBody(m_pBody);
+        m_pWorld->m_Bodies.destroy(m_pBody);
+        m_pBody = NULL;
+    }
+    if( m_pState != NULL )
+    {
+        m_pWorld->m_States.destroy(m_pState);
+        m_pState = NULL;
+    }
+
+    // Shape is owned by shapes cache
+    m_pShape = NULL;
+}
+
+void CObject::destroyMesh()
+{
+    if( m_pEntity != NULL )
+    {
+        m_pGame->m_pSceneMgr->destroyEntity(m_pEntity);
+        m_pEntity = NULL;
+    }
+    if( m_pNode != NULL )
+    {
+        m_pGame->m_pSceneMgr->destroySceneNode(m_pNode);
+        m_pNode = NULL;
+    }
+}
+
+void CObject::saveState()
+{
+    if( m_pState != NULL )
+        m_pState->saveTransform();
+
+    for( std::vector<CObject*>::iterator it = m_Childrens.begin(); it != m_Childrens.end(); it++ )
+        (*it)->saveState();
+}
+
+void CObject::interpolate(const Ogre::Real alpha)
+{
+    if( m_pState != NULL )
+        m_pState->interpolate(alpha);
+
+    for( std::vector<CObject*>::iterator it = m_Childrens.begin(); it != m_Childrens.end(); it++ )
+        (*it)->interpolate(alpha);
+}
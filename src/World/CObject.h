@@ -23,12 +23,18 @@
 #include "btogre/BtOgrePG.h"
 
 #include "CMaster.h"
+#include "CSlotMap.h"
+#include "CPool.h"
 #include "Nerv/CAction.h"
 
 class CWorld;
 class CGame;
 
 /** @brief Father of all objects in game
+ *
+ *  World does not call update() of its objects every tick: movement of
+ * objects is updated by world systems (CKernelSystem), per tick behaviour
+ * of new objects belongs to a system too.
  */
 class CObject
     : public CMaster
@@ -64,6 +70,23 @@ public:
      */
     void setWorld(CWorld* pWorld){ m_pWorld = pWorld; }
 
+    /** @brief Setting pool of object memory
+     *
+     * @param pPool - Pool object was constructed in, NULL - object was created by new
+     * @return void
+     *
+     */
+    void setPool(CPool* pPool){ m_pPool = pPool; }
+
+    /** @brief Destroy object created by new or in pool
+     *
+     * @param pObject
+     * @return void
+     *
+     * Memory of pooled object is returned to its pool.
+     */
+    static void destroy(CObject* pObject);
+
 
     /** @brief Delete all children objects
      *
@@ -80,6 +103,16 @@ public:
      */
     void attachChild(CObject* pChild);
 
+    /** @brief Remove and destroy child object
+     *
+     * @param pChild
+     * @return void
+     *
+     * Last child takes place of removed one. Must not be called while
+     * childrens are updated.
+     */
+    void removeChild(CObject* pChild);
+
     /** @brief Return childrens list
      *
      * @return std::vector<CObject*>*
@@ -93,6 +126,54 @@ public:
      */
     Ogre::SceneNode* node(){ return m_pNode; }
 
+    /** @brief Gets entity of current object
+     *
+     * @return Ogre::Entity* - NULL in headless mode
+     */
+    Ogre::Entity* entity(){ return m_pEntity; }
+
+    /** @brief Gets gravity state of object in world gravity field
+     *
+     * @return const SSlotHandle& - Not valid if object is not affected by gravity field
+     */
+    const SSlotHandle& gravityHandle() const { return m_GravityHandle; }
+
+    /** @brief Create object scene node with mesh
+     *
+     * @param mesh - Name of mesh resource
+     * @return void
+     *
+     * In headless mode entity is not created. Collision shape of mesh is
+     * taken from shapes cache of game.
+     */
+    void createMesh(const char* mesh);
+
+    /** @brief Create rigid body of object in world pools
+     *
+     * @param group - Collision group of body
+     * @param mask - Collision groups of bodies to collide with
+     * @return void
+     *
+     * Shape, mass and scene node must be set before. Motion state and
+     * body are returned to pools by destructor.
+     */
+    void createBody(short group, short mask);
+
+    /** @brief Remember physics state of object and childrens before simulation tick
+     *
+     * @return void
+     *
+     */
+    void saveState();
+
+    /** @brief Move scene nodes between two last simulation ticks
+     *
+     * @param alpha - Interpolation factor in [0, 1]
+     * @return void
+     *
+     */
+    virtual void interpolate(const Ogre::Real alpha);
+
     /** @brief Groups for collision detection
      */
     enum CollisionObjectGroup {
@@ -106,7 +187,6 @@ protected:
 
     bool                                 m_HasChild; ///< Object is has any child
     std::vector<CObject*>                m_Childrens; ///< List of child objects
-    std::vector<CObject*>::iterator      m_itChildrens; ///< Current processing child object
 
     CObject*                             m_pParent; ///< Pointer to parent object
     CGame*                               m_pGame;   ///< Pointer to Game Object
@@ -120,8 +200,26 @@ protected:
     btCollisionShape*                    m_pShape;   ///< Shape of collision
     btScalar                             m_Mass;     ///< Mass of object
     BtOgre::RigidBodyState*              m_pState;   ///< Rigid body state
+    SSlotHandle                          m_GravityHandle; ///< Gravity state in world gravity field
+
+    CPool*                               m_pPool;    ///< Pool of object memory, NULL if object created by new
+    uint                                 m_ChildIndex; ///< Index of object in childrens of parent
 
 private:
+    /** @brief Remove body from physics world and return it to pools
+     *
+     * @return void
+     *
+     */
+    void destroyBody();
+
+    /** @brief Destroy entity and scene node of object
+     *
+     * @return void
+     *
+     */
+    void destroyMesh();
+
     /** @brief Fake copy constructor
      *
      * @param obj
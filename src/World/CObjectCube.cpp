@@ -15,6 +15,7 @@
 #include "World/CObjectCube.h"
 #include "CGravityField.h"
 #include "CGame.h"
+#include "World/CShapeCache.h"
 
 CObjectCube::CObjectCube(CWorld& pWorld, CObjectCube::Cube_Size size, const Ogre::Vector3& pos)
     : CObject("Cube", pWorld, pos)
@@ -27,30 +28,18 @@ void CObjectCube::init()
     if( m_pParent != NULL )
     {
         //Create Ogre stuff.
-        m_pEntity = m_pGame->m_pSceneMgr->createEntity("objectcube.mesh");
-        m_pNode = m_pParent->node()->createChildSceneNode(m_Position);
-        m_pNode->attachObject(m_pEntity);
+        createMesh("objectcube.mesh");
         m_pNode->scale(Ogre::Vector3(m_CubeSize));
 
-        //Create shape.
-        BtOgre::StaticMeshToShapeConverter converter(m_pEntity);
-        m_pShape = converter.createBox();
-        m_pShape->setLocalScaling(btVector3(m_CubeSize, m_CubeSize, m_CubeSize));
+        //Get shape, shared by cubes of the same size.
+        m_pShape = m_pGame->shapeCache()->shape("objectcube.mesh", CShapeCache::SHAPE_BOX, btVector3(m_CubeSize, m_CubeSize, m_CubeSize));
 
-        //Calculate inertia.
+        //Static body, motion state and body are taken from world pools.
         m_Mass = 0;
-        btVector3 inertia;
-        m_pShape->calculateLocalInertia(m_Mass, inertia);
-
-        //Create BtOgre MotionState (connects Ogre and Bullet).
-        m_pState = new BtOgre::RigidBodyState(m_pNode);
-
-        //Create the Body.
-        m_pBody = new btRigidBody(m_Mass, m_pState, m_pShape, inertia);
-        m_pWorld->m_pPhyWorld->addRigidBody(m_pBody, CObject::STATIC_OBJECT, CObject::DYNAMIC_OBJECT);
+        createBody(CObject::STATIC_OBJECT, CObject::DYNAMIC_OBJECT);
 
         // Get size of cube
-        Ogre::Vector3 size = converter.getSize()*m_CubeSize;
+        Ogre::Vector3 size = m_pGame->shapeCache()->size("objectcube.mesh")*m_CubeSize;
 
         float wc = 0.75f;         // Width coefficient
         float hc = 0.125f;        // Height coefficient
@@ -58,27 +47,26 @@ void CObjectCube::init()
 
         // Create Force Field around cube
         // +Y (Up)
-        m_GravityVolumes[0] = m_pWorld->m_pGravityField->add(new CGravityElement(new btVector3(size.x*wc, size.y*hc, size.z*wc), new btVector3(m_Position.x, m_Position.y+size.y*pc, m_Position.z), new btVector3(0.0f, -1.0f, 0.0f)));
+        m_GravityVolumes[0] = m_pWorld->m_pGravityField->add(btVector3(size.x*wc, size.y*hc, size.z*wc), btVector3(m_Position.x, m_Position.y+size.y*pc, m_Position.z), btVector3(0.0f, -1.0f, 0.0f));
         // -Y (Down)
-        m_GravityVolumes[1] = m_pWorld->m_pGravityField->add(new CGravityElement(new btVector3(size.x*wc, size.y*hc, size.z*wc), new btVector3(m_Position.x, m_Position.y-size.y*pc, m_Position.z), new btVector3(0.0f, 1.0f, 0.0f)));
+        m_GravityVolumes[1] = m_pWorld->m_pGravityField->add(btVector3(size.x*wc, size.y*hc, size.z*wc), btVector3(m_Position.x, m_Position.y-size.y*pc, m_Position.z), btVector3(0.0f, 1.0f, 0.0f));
         // +X (Right)
-        m_GravityVolumes[2] = m_pWorld->m_pGravityField->add(new CGravityElement(new btVector3(size.x*hc, size.y*wc, size.z*wc), new btVector3(m_Position.x+size.x*pc, m_Position.y, m_Position.z), new btVector3(-1.0f, 0.0f, 0.0f)));
+        m_GravityVolumes[2] = m_pWorld->m_pGravityField->add(btVector3(size.x*hc, size.y*wc, size.z*wc), btVector3(m_Position.x+size.x*pc, m_Position.y, m_Position.z), btVector3(-1.0f, 0.0f, 0.0f));
         // -X (Left)
-        m_GravityVolumes[3] = m_pWorld->m_pGravityField->add(new CGravityElement(new btVector3(size.x*hc, size.y*wc, size.z*wc), new btVector3(m_Position.x-size.x*pc, m_Position.y, m_Position.z), new btVector3(1.0f, 0.0f, 0.0f)));
+        m_GravityVolumes[3] = m_pWorld->m_pGravityField->add(btVector3(size.x*hc, size.y*wc, size.z*wc), btVector3(m_Position.x-size.x*pc, m_Position.y, m_Position.z), btVector3(1.0f, 0.0f, 0.0f));
         // +Z (Front)
-        m_GravityVolumes[4] = m_pWorld->m_pGravityField->add(new CGravityElement(new btVector3(size.x*wc, size.y*wc, size.z*hc), new btVector3(m_Position.x, m_Position.y, m_Position.z+size.z*pc), new btVector3(0.0f, 0.0f, -1.0f)));
+        m_GravityVolumes[4] = m_pWorld->m_pGravityField->add(btVector3(size.x*wc, size.y*wc, size.z*hc), btVector3(m_Position.x, m_Position.y, m_Position.z+size.z*pc), btVector3(0.0f, 0.0f, -1.0f));
         // -Z (Back)
-        m_GravityVolumes[5] = m_pWorld->m_pGravityField->add(new CGravityElement(new btVector3(size.x*wc, size.y*wc, size.z*hc), new btVector3(m_Position.x, m_Position.y, m_Position.z-size.z*pc), new btVector3(0.0f, 0.0f, 1.0f)));
+        m_GravityVolumes[5] = m_pWorld->m_pGravityField->add(btVector3(size.x*wc, size.y*wc, size.z*hc), btVector3(m_Position.x, m_Position.y, m_Position.z-size.z*pc), btVector3(0.0f, 0.0f, 1.0f));
     }
 }
 
 CObjectCube::~CObjectCube()
 {
-    // @todo Remove gravity fields
-    //for(int i=0; i<6; i++)
-    //    m_pWorld->m_pGravityField->remove(i);
-}
-
-void CObjectCube::update(const Ogre::Real)
-{
+    // Elements are returned to pool of field
+    for( int i = 0; i < 6; i++ )
+    {
+        if( m_GravityVolumes[i].valid() )
+            m_pWorld->m_pGravityField->remove(m_GravityVolumes[i]);
+    }
 }
@@ -65,14 +65,6 @@ public:
      */
     void cubeSize(CObjectCube::Cube_Size cube_size) { m_CubeSize = cube_size; }
 
-    /** @brief Update object data, it may be animation or just object translation or so on
-     *
-     * @param time_since_last_frame
-     * @return void
-     *
-     */
-    void update(const Ogre::Real time_since_last_frame);
-
     /** @brief Initialize object
      *
      * @return void
@@ -90,7 +82,7 @@ public:
 
 private:
     CObjectCube::Cube_Size  m_CubeSize; ///< Size of cube
-    int                     m_GravityVolumes[6]; ///< Ids of connected gravity elements
+    SSlotHandle             m_GravityVolumes[6]; ///< Handles of connected gravity elements
 };
 
 
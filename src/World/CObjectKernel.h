@@ -29,7 +29,8 @@
  * control cube of controlled object).
  *
  *  Sphere can move by rotating (up, down, left, right) in the direction
- * of user camera.
+ * of user camera. Movement state is kept and updated by kernel system of
+ * world.
  */
 class CObjectKernel
     : public virtual CControlled
@@ -49,15 +50,6 @@ public:
      */
     ~CObjectKernel();
 
-
-    /** @brief Update object data, it may be animation or just object translation or so on
-     *
-     * @param time_since_last_frame
-     * @return void
-     *
-     */
-    void update(const Ogre::Real time_since_last_frame);
-
     /** @brief Initialize object
      *
      * @return void
@@ -92,14 +84,10 @@ private:
     void registerActions();
 
     Ogre::Vector3 m_Front;        ///< Look vector of object
-    btVector3 m_Gravity;          ///< Last gravity vector
 
-    Ogre::Vector3 m_ActMove;      ///< Action move
-    Ogre::Vector3 m_Velocity;     ///< Current velocity
-    Ogre::Quaternion m_Direction; ///< Current rotation state
+    float m_SpeedMax;    ///< Maximum speed
 
-    float m_SpeedMin;    ///< Maximum speed
-    float m_SpeedMax;    ///< Minimum speed
+    SSlotHandle m_KernelHandle;   ///< Movement state in kernel system of world
 };
 
 #endif // COBJECTKERNEL_H_INCLUDED
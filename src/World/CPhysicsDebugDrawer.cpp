@@ -0,0 +1,168 @@
+/**
+ * @file    CPhysicsDebugDrawer.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Culled and budgeted debug drawing of physics world
+ *
+ *
+ */
+
+#define LOG_SUBSYSTEM Common::CLog::SYS_WORLD ///< Log subsystem of file
+
+#include "World/CPhysicsDebugDrawer.h"
+#include "CProfiler.h"
+
+#include <cstring>
+
+CPhysicsDebugDrawer::CPhysicsDebugDrawer(btCollisionWorld* pWorld, Ogre::SceneManager* pSceneMgr, pugi::xml_node config)
+    : m_pWorld(pWorld)
+    , m_pSceneMgr(pSceneMgr)
+    , m_pNode()
+    , m_pStatic(new DebugRenderable(Ogre::RenderOperation::OT_LINE_LIST))
+    , m_pDynamic(new DebugRenderable(Ogre::RenderOperation::OT_LINE_LIST))
+    , m_StaticLines(Ogre::VertexElement::getBestColourVertexElementType())
+    , m_DynamicLines(Ogre::VertexElement::getBestColourVertexElementType())
+    , m_pTarget(&m_DynamicLines)
+    , m_Colour(Ogre::ColourValue::White)
+    , m_DebugMode(DBG_DrawWireframe)
+    , m_Enabled(true)
+    , m_Distance(500.0f)
+    , m_Budget(200000)
+    , m_Lines(0)
+    , m_StaticRefresh(30)
+    , m_StaticFrame(0)
+    , m_StaticEye(Ogre::Vector3::ZERO)
+{
+    if( *config.child_value("draw") )
+        m_Enabled = (std::strcmp(config.child_value("draw"), "Yes") == 0);
+    if( *config.child_value("distance") )
+        m_Distance = Ogre::StringConverter::parseReal(config.child_value("distance"), m_Distance);
+    if( *config.child_value("budget") )
+        m_Budget = Ogre::StringConverter::parseUnsignedInt(config.child_value("budget"), m_Budget);
+    if( *config.child_value("static_refresh") )
+        m_StaticRefresh = Ogre::StringConverter::parseUnsignedInt(config.child_value("static_refresh"), m_StaticRefresh);
+    if( m_StaticRefresh == 0 )
+        m_StaticRefresh = 1;
+
+    m_pStatic->setMaterial("debug_draw");
+    m_pDynamic->setMaterial("debug_draw");
+
+    m_pNode = m_pSceneMgr->getRootSceneNode()->createChildSceneNode();
+    m_pNode->attachObject(m_pStatic);
+    m_pNode->attachObject(m_pDynamic);
+
+    // First draw() fills static geometry
+    m_StaticFrame = m_StaticRefresh;
+
+    log_debug("Physics debug drawing %s: distance %f, budget %u lines", m_Enabled ? "on" : "off", m_Distance, m_Budget);
+}
+
+CPhysicsDebugDrawer::~CPhysicsDebugDrawer()
+{
+    m_pNode->detachAllObjects();
+    m_pSceneMgr->destroySceneNode(m_pNode);
+    delete m_pStatic;
+    delete m_pDynamic;
+}
+
+void CPhysicsDebugDrawer::enabled(bool enabled)
+{
+    m_Enabled = enabled;
+    m_StaticFrame = m_StaticRefresh;
+}
+
+void CPhysicsDebugDrawer::draw(const Ogre::Camera* pCamera)
+{
+    PROFILE_ZONE("CPhysicsDebugDrawer::draw");
+
+    m_DynamicLines.clear();
+
+    if( ! m_Enabled )
+    {
+        m_StaticLines.clear();
+        m_pStatic->update(m_StaticLines.lineVertices, m_StaticLines.lineIndices);
+        m_pDynamic->update(m_DynamicLines.lineVertices, m_DynamicLines.lineIndices);
+        return;
+    }
+
+    // Static geometry takes budget first, dynamic objects get the rest.
+    // Lines of static objects are kept until redraw, they are culled only
+    // by distance - turn of camera needs no redraw, move of camera by tenth
+    // of draw distance does.
+    const Ogre::Vector3& eye = pCamera->getDerivedPosition();
+    uint static_lines = static_cast<uint>(m_StaticLines.lineIndices.size() / 2);
+    if( (++m_StaticFrame >= m_StaticRefresh) || (eye.squaredDistance(m_StaticEye) > 0.01f * m_Distance * m_Distance) )
+    {
+        m_StaticFrame = 0;
+        m_StaticEye = eye;
+        m_StaticLines.clear();
+        m_pTarget = &m_StaticLines;
+        m_Lines = m_Budget;
+        drawObjects(true, pCamera);
+        m_pStatic->update(m_StaticLines.lineVertices, m_StaticLines.lineIndices);
+        static_lines = m_Budget - m_Lines;
+    }
+
+    m_pTarget = &m_DynamicLines;
+    m_Lines = m_Budget - static_lines;
+    drawObjects(false, pCamera);
+    m_pDynamic->update(m_DynamicLines.lineVertices, m_DynamicLines.lineIndices);
+}
+
+void CPhysicsDebugDrawer::drawObjects(bool fixed, const Ogre::Camera* pCamera)
+{
+    const Ogre::Vector3& eye = pCamera->getDerivedPosition();
+    const Ogre::Real distance = m_Distance * m_Distance;
+
+    btCollisionObjectArray& objects = m_pWorld->getCollisionObjectArray();
+    for( int i = 0; (i < objects.size()) && (m_Lines > 0); i++ )
+    {
+        btCollisionObject* obj = objects[i];
+        const btRigidBody* body = btRigidBody::upcast(obj);
+        if( ((body == NULL) || body->isStaticObject()) != fixed )
+            continue;
+
+        // Broadphase keeps world box of every object
+        btBroadphaseProxy* proxy = obj->getBroadphaseHandle();
+        if( proxy == NULL )
+            continue;
+        Ogre::AxisAlignedBox box(BtOgre::Convert::toOgre(proxy->m_aabbMin), BtOgre::Convert::toOgre(proxy->m_aabbMax));
+
+        Ogre::Vector3 nearest = eye;
+        nearest.makeCeil(box.getMinimum());
+        nearest.makeFloor(box.getMaximum());
+        if( (nearest.squaredDistance(eye) > distance) || (! fixed && ! pCamera->isVisible(box)) )
+            continue;
+
+        if( body == NULL )
+            m_Colour = Ogre::ColourValue(1.0f, 0.5f, 0.0f, 0.3f);
+        else if( fixed )
+            m_Colour = Ogre::ColourValue(0.5f, 0.5f, 0.5f);
+        else if( obj->getActivationState() == ISLAND_SLEEPING )
+            m_Colour = Ogre::ColourValue::Green;
+        else
+            m_Colour = Ogre::ColourValue::White;
+
+        m_pWorld->debugDrawObject(obj->getWorldTransform(), obj->getCollisionShape(), btVector3(m_Colour.r, m_Colour.g, m_Colour.b));
+    }
+}
+
+void CPhysicsDebugDrawer::drawLine(const btVector3& from, const btVector3& to, const btVector3&)
+{
+    // Lines over budget are dropped
+    if( m_Lines == 0 )
+        return;
+    m_Lines--;
+
+    m_pTarget->buildLine(BtOgre::Convert::toOgre(from), BtOgre::Convert::toOgre(to), m_Colour, m_Colour.a);
+}
+
+void CPhysicsDebugDrawer::reportErrorWarning(const char* warningString)
+{
+    log_warn("Bullet: %s", warningString);
+}
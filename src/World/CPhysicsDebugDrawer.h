@@ -0,0 +1,152 @@
+/**
+ * @file    CPhysicsDebugDrawer.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Culled and budgeted debug drawing of physics world
+ *
+ *
+ */
+
+#ifndef CPHYSICSDEBUGDRAWER_H
+#define CPHYSICSDEBUGDRAWER_H
+
+#include "Common.h"
+
+#include <OGRE/Ogre.h>
+
+#include "btogre/BtOgreExtras.h"
+#include "pugixml/pugixml.hpp"
+
+#include "OgreDebugDrawer/DebugDrawer.h"
+
+/** @brief Debug drawing of collision shapes
+ *
+ *  Only objects in draw distance are drawn, lines over frame budget are
+ * dropped. Static objects and ghosts (gravity volumes) are drawn into own
+ * buffers every few frames or when camera moved, dynamic objects are drawn
+ * every frame and only in camera frustum. Buffers have 32-bit indices, so size of world is
+ * limited only by budget.
+ */
+class CPhysicsDebugDrawer
+    : public btIDebugDraw
+{
+public:
+    /** @brief Create drawer and attach its geometry to scene
+     *
+     * @param pWorld - Physics world
+     * @param pSceneMgr - Scene manager
+     * @param config - Debug config node (draw, distance, budget, static_refresh)
+     */
+    CPhysicsDebugDrawer(btCollisionWorld* pWorld, Ogre::SceneManager* pSceneMgr, pugi::xml_node config);
+
+    /** @brief Destructor
+     */
+    ~CPhysicsDebugDrawer();
+
+    /** @brief Draw objects visible by camera
+     *
+     * @param pCamera - Camera of frame
+     * @return void
+     */
+    void draw(const Ogre::Camera* pCamera);
+
+    /** @brief Drawing is enabled
+     *
+     * @return bool
+     */
+    inline bool enabled() const { return m_Enabled; }
+
+    /** @brief Enable or disable drawing
+     *
+     * @param enabled - New state
+     * @return void
+     *
+     * Static geometry is redrawn by next draw().
+     */
+    void enabled(bool enabled);
+
+    /** @brief Add line of shape
+     *
+     * @see btIDebugDraw::drawLine()
+     */
+    void drawLine(const btVector3& from, const btVector3& to, const btVector3& color);
+
+    /** @brief Contact points are not drawn
+     *
+     * @see btIDebugDraw::drawContactPoint()
+     */
+    void drawContactPoint(const btVector3&, const btVector3&, btScalar, int, const btVector3&) {}
+
+    /** @brief Write Bullet warning to log
+     *
+     * @see btIDebugDraw::reportErrorWarning()
+     */
+    void reportErrorWarning(const char* warningString);
+
+    /** @brief Text is not drawn
+     *
+     * @see btIDebugDraw::draw3dText()
+     */
+    void draw3dText(const btVector3&, const char*) {}
+
+    /** @brief Set Bullet debug mode flags
+     *
+     * @see btIDebugDraw::setDebugMode()
+     */
+    void setDebugMode(int debugMode) { m_DebugMode = debugMode; }
+
+    /** @brief Bullet debug mode flags
+     *
+     * @see btIDebugDraw::getDebugMode()
+     */
+    int getDebugMode() const { return m_DebugMode; }
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CPhysicsDebugDrawer(const CPhysicsDebugDrawer& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CPhysicsDebugDrawer& operator=(const CPhysicsDebugDrawer& obj);
+
+    /** @brief Draw static or dynamic objects into current geometry
+     *
+     * @param fixed - Static objects and ghosts, or dynamic objects
+     * @param pCamera - Camera of frame
+     * @return void
+     */
+    void drawObjects(bool fixed, const Ogre::Camera* pCamera);
+
+    btCollisionWorld*       m_pWorld;        ///< Physics world
+    Ogre::SceneManager*     m_pSceneMgr;     ///< Scene manager of geometry
+    Ogre::SceneNode*        m_pNode;         ///< Node of renderables
+    DebugRenderable*        m_pStatic;       ///< Buffers of static objects
+    DebugRenderable*        m_pDynamic;      ///< Buffers of dynamic objects
+    DebugGeometry           m_StaticLines;   ///< Lines of static objects
+    DebugGeometry           m_DynamicLines;  ///< Lines of dynamic objects
+    DebugGeometry*          m_pTarget;       ///< Geometry of drawLine()
+    Ogre::ColourValue       m_Colour;        ///< Colour of drawn object
+    int                     m_DebugMode;     ///< Bullet debug mode flags
+    bool                    m_Enabled;       ///< Drawing is enabled
+    Ogre::Real              m_Distance;      ///< Draw distance from camera
+    uint                    m_Budget;        ///< Maximum lines of frame
+    uint                    m_Lines;         ///< Lines left in budget of current geometry
+    uint                    m_StaticRefresh; ///< Frames between static geometry redraw
+    uint                    m_StaticFrame;   ///< Frames since static geometry redraw
+    Ogre::Vector3           m_StaticEye;     ///< Camera position of static geometry redraw
+};
+
+#endif // CPHYSICSDEBUGDRAWER_H
@@ -0,0 +1,365 @@
+/**
+ * @file    CShapeCache.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Shared collision shapes of meshes
+ *
+ *
+ */
+
+#define LOG_SUBSYSTEM Common::CLog::SYS_WORLD ///< Log subsystem of file
+
+#include "World/CShapeCache.h"
+#include "CDataSnapshot.h"
+
+#include <BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+const char CShapeCache::s_Magic[4] = { 'T', 'D', 'S', 'H' };
+const uint32_t CShapeCache::s_Version = 2;
+
+CShapeCache::SGeometry::~SGeometry()
+{
+    delete m_pArray;
+
+    // BVH is placed in buffer
+    if( m_pBvh != NULL )
+        m_pBvh->~btOptimizedBvh();
+    btAlignedFree(m_pBvhBuffer);
+}
+
+bool CShapeCache::SShapeKey::operator<(const SShapeKey& key) const
+{
+    if( m_Kind != key.m_Kind )
+        return m_Kind < key.m_Kind;
+    for( int i = 0; i < 3; i++ )
+    {
+        if( m_Scale[i] != key.m_Scale[i] )
+            return m_Scale[i] < key.m_Scale[i];
+    }
+
+    return m_Mesh < key.m_Mesh;
+}
+
+CShapeCache::CShapeCache(const char* path)
+    : m_Path(path)
+    , m_Geometries()
+    , m_Shapes()
+    , m_Created()
+    , m_Mutex()
+{
+    if( ! m_Path.empty() )
+        log_info("Shapes cache directory \"%s\"", m_Path.c_str());
+}
+
+CShapeCache::~CShapeCache()
+{
+    // Scaled shapes refer to shapes created before
+    for( std::vector<btCollisionShape*>::reverse_iterator it = m_Created.rbegin(); it != m_Created.rend(); ++it )
+        delete *it;
+
+    for( std::map<std::string, SGeometry*>::iterator it = m_Geometries.begin(); it != m_Geometries.end(); ++it )
+        delete it->second;
+}
+
+btCollisionShape* CShapeCache::shape(const char* mesh, ShapeKind kind, const btVector3& scale)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    return get(mesh, kind, scale);
+}
+
+Ogre::Vector3 CShapeCache::size(const char* mesh)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    return BtOgre::Convert::toOgre(geometry(mesh).m_Size);
+}
+
+size_t CShapeCache::shapes()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    return m_Created.size();
+}
+
+btCollisionShape* CShapeCache::get(const std::string& mesh, ShapeKind kind, const btVector3& scale)
+{
+    SShapeKey key(mesh, kind, scale);
+    std::map<SShapeKey, btCollisionShape*>::iterator it = m_Shapes.find(key);
+    if( it != m_Shapes.end() )
+        return it->second;
+
+    btCollisionShape* shape = create(mesh, kind, scale);
+    m_Shapes.insert(std::make_pair(key, shape));
+    m_Created.push_back(shape);
+
+    return shape;
+}
+
+CShapeCache::SGeometry& CShapeCache::geometry(const std::string& mesh)
+{
+    std::map<std::string, SGeometry*>::iterator it = m_Geometries.find(mesh);
+    if( it != m_Geometries.end() )
+        return *it->second;
+
+    SGeometry* geom = new SGeometry();
+    m_Geometries[mesh] = geom;
+
+    // Modification time has 1 second resolution, content of mesh file decides
+    if( ! m_Path.empty() )
+    {
+        Ogre::ResourceGroupManager& groups = Ogre::ResourceGroupManager::getSingleton();
+        Ogre::DataStreamPtr stream = groups.openResource(mesh, groups.findGroupContainingResource(mesh));
+        std::string content(stream->getAsString());
+        stream->close();
+        geom->m_FileSize = content.size();
+        geom->m_Hash = CDataSnapshot::hash(content.data(), content.size());
+    }
+    if( load(mesh, *geom) )
+    {
+        log_debug("Restored geometry of mesh \"%s\" from cache", mesh.c_str());
+        return *geom;
+    }
+
+    // Read back vertices from mesh buffers
+    BtOgre::StaticMeshToShapeConverter converter;
+    converter.addMesh(Ogre::MeshManager::getSingleton().load(mesh, Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME));
+    if( converter.getVertexCount() == 0 )
+        throw EXCEPTION("Mesh \"" + mesh + "\" has no vertices");
+
+    const Ogre::Vector3* vertices = converter.getVertices();
+    geom->m_Vertices.reserve(converter.getVertexCount() * 3);
+    for( unsigned int i = 0; i < converter.getVertexCount(); i++ )
+    {
+        geom->m_Vertices.push_back(vertices[i].x);
+        geom->m_Vertices.push_back(vertices[i].y);
+        geom->m_Vertices.push_back(vertices[i].z);
+    }
+
+    const unsigned int* indices = converter.getIndices();
+    geom->m_Indices.reserve(converter.getIndexCount());
+    for( unsigned int i = 0; i < converter.getIndexCount(); i++ )
+        geom->m_Indices.push_back(static_cast<int>(indices[i]));
+
+    geom->m_Size = BtOgre::Convert::toBullet(converter.getSize());
+    geom->m_Radius = converter.getRadius();
+    log_debug("Read geometry of mesh \"%s\": %u vertices, %u indices", mesh.c_str(), converter.getVertexCount(), converter.getIndexCount());
+
+    save(mesh, *geom);
+
+    return *geom;
+}
+
+btCollisionShape* CShapeCache::create(const std::string& mesh, ShapeKind kind, const btVector3& scale)
+{
+    SGeometry& geom = geometry(mesh);
+
+    btCollisionShape* shape = NULL;
+    switch( kind )
+    {
+    case SHAPE_SPHERE:
+        shape = new btSphereShape(geom.m_Radius);
+        break;
+    case SHAPE_BOX:
+        shape = new btBoxShape(geom.m_Size * 0.5f);
+        break;
+    case SHAPE_CYLINDER:
+        shape = new btCylinderShapeX(geom.m_Size * 0.5f);
+        break;
+    case SHAPE_CONVEX:
+        shape = new btConvexHullShape(&geom.m_Vertices[0], static_cast<int>(geom.m_Vertices.size() / 3), static_cast<int>(3 * sizeof(btScalar)));
+        break;
+    case SHAPE_TRIMESH:
+        if( geom.m_Indices.size() < 3 )
+            throw EXCEPTION("Mesh \"" + mesh + "\" has no triangles");
+
+        // Scaled trimesh shares BVH of not scaled one
+        if( scale != btVector3(1.0f, 1.0f, 1.0f) )
+        {
+            btBvhTriangleMeshShape* trimesh = static_cast<btBvhTriangleMeshShape*>(get(mesh, SHAPE_TRIMESH, btVector3(1.0f, 1.0f, 1.0f)));
+            return new btScaledBvhTriangleMeshShape(trimesh, scale);
+        }
+
+        if( geom.m_pArray == NULL )
+        {
+            geom.m_pArray = new btTriangleIndexVertexArray(static_cast<int>(geom.m_Indices.size() / 3), &geom.m_Indices[0], static_cast<int>(3 * sizeof(int)),
+                                                           static_cast<int>(geom.m_Vertices.size() / 3), &geom.m_Vertices[0], static_cast<int>(3 * sizeof(btScalar)));
+        }
+
+        if( geom.m_pBvh == NULL )
+        {
+            btVector3 aabb_min, aabb_max;
+            geom.m_pArray->calculateAabbBruteForce(aabb_min, aabb_max);
+
+            // BVH is kept in serialized form, the same as restored from disk
+            btOptimizedBvh* bvh = new btOptimizedBvh();
+            bvh->build(geom.m_pArray, true, aabb_min, aabb_max);
+            geom.m_BvhSize = bvh->calculateSerializeBufferSize();
+            geom.m_pBvhBuffer = btAlignedAlloc(geom.m_BvhSize, 16);
+            bvh->serializeInPlace(geom.m_pBvhBuffer, geom.m_BvhSize, false);
+            delete bvh;
+            geom.m_pBvh = btOptimizedBvh::deSerializeInPlace(geom.m_pBvhBuffer, geom.m_BvhSize, false);
+            log_debug("Built BVH of mesh \"%s\": %u bytes", mesh.c_str(), geom.m_BvhSize);
+
+            save(mesh, geom);
+        }
+
+        {
+            btBvhTriangleMeshShape* trimesh = new btBvhTriangleMeshShape(geom.m_pArray, true, false);
+            trimesh->setOptimizedBvh(geom.m_pBvh);
+            shape = trimesh;
+        }
+        break;
+    }
+
+    if( scale != btVector3(1.0f, 1.0f, 1.0f) )
+        shape->setLocalScaling(scale);
+
+    return shape;
+}
+
+bool CShapeCache::load(const std::string& mesh, SGeometry& geom) const
+{
+    if( m_Path.empty() )
+        return false;
+
+    fs::path path = filePath(mesh);
+    std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+    if( ! file )
+        return false;
+
+    SShapeCacheHeader header;
+    if( ! file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.m_Magic, s_Magic, sizeof(header.m_Magic)) != 0 )
+        return log_error("File \"%s\" is not a shapes cache", path.c_str());
+
+    if( header.m_Version != s_Version || header.m_Bullet != static_cast<uint32_t>(btGetVersion())
+        || header.m_Scalar != sizeof(btScalar) || header.m_FileSize != geom.m_FileSize || header.m_Hash != geom.m_Hash )
+    {
+        log_info("Shapes cache \"%s\" is outdated", path.c_str());
+        return false;
+    }
+
+    std::string name(mesh.size(), '\0');
+    if( header.m_Name != mesh.size() || (! name.empty() && ! file.read(&name[0], static_cast<std::streamsize>(name.size()))) || name != mesh )
+        return log_error("Shapes cache \"%s\" is not of mesh \"%s\"", path.c_str(), mesh.c_str());
+
+    std::vector<btScalar> vertices(static_cast<size_t>(header.m_Vertices) * 3);
+    std::vector<int> indices(header.m_Indices);
+    if( (vertices.empty() || file.read(reinterpret_cast<char*>(&vertices[0]), static_cast<std::streamsize>(vertices.size() * sizeof(btScalar))))
+        && (indices.empty() || file.read(reinterpret_cast<char*>(&indices[0]), static_cast<std::streamsize>(indices.size() * sizeof(int)))) )
+    {
+        void* bvh_buffer = NULL;
+        btOptimizedBvh* bvh = NULL;
+        if( header.m_Bvh > 0 )
+        {
+            bvh_buffer = btAlignedAlloc(header.m_Bvh, 16);
+            if( file.read(static_cast<char*>(bvh_buffer), header.m_Bvh) )
+                bvh = btOptimizedBvh::deSerializeInPlace(bvh_buffer, header.m_Bvh, false);
+        }
+
+        // Indices must refer to vertices
+        bool valid = (vertices.size() > 0) && (header.m_Bvh == 0 || bvh != NULL) && (indices.size() % 3 == 0);
+        for( size_t i = 0; valid && i < indices.size(); i++ )
+            valid = (indices[i] >= 0) && (static_cast<uint32_t>(indices[i]) < header.m_Vertices);
+
+        if( valid )
+        {
+            geom.m_Vertices.swap(vertices);
+            geom.m_Indices.swap(indices);
+            geom.m_Size = btVector3(header.m_Size[0], header.m_Size[1], header.m_Size[2]);
+            geom.m_Radius = header.m_Radius;
+            geom.m_pBvh = bvh;
+            geom.m_pBvhBuffer = bvh_buffer;
+            geom.m_BvhSize = header.m_Bvh;
+            return true;
+        }
+
+        if( bvh != NULL )
+            bvh->~btOptimizedBvh();
+        btAlignedFree(bvh_buffer);
+    }
+
+    return log_error("Shapes cache \"%s\" is corrupted", path.c_str());
+}
+
+bool CShapeCache::save(const std::string& mesh, const SGeometry& geom) const
+{
+    if( m_Path.empty() )
+        return false;
+
+    boost::system::error_code ec;
+    if( ! fs::is_directory(m_Path, ec) && ! fs::create_directories(m_Path, ec) )
+        return log_error("Can't create shapes cache directory \"%s\"", m_Path.c_str());
+
+    // Cache file is replaced at once, reader never gets partially written file
+    fs::path path = filePath(mesh);
+    std::string tmp_path(path.string());
+    tmp_path += ".tmp";
+
+    std::ofstream file(tmp_path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if( ! file )
+        return log_error("Can't create shapes cache \"%s\"", path.c_str());
+
+    SShapeCacheHeader header;
+    std::memcpy(header.m_Magic, s_Magic, sizeof(header.m_Magic));
+    header.m_Version = s_Version;
+    header.m_Bullet = static_cast<uint32_t>(btGetVersion());
+    header.m_Scalar = sizeof(btScalar);
+    header.m_FileSize = geom.m_FileSize;
+    header.m_Hash = geom.m_Hash;
+    header.m_Vertices = static_cast<uint32_t>(geom.m_Vertices.size() / 3);
+    header.m_Indices = static_cast<uint32_t>(geom.m_Indices.size());
+    header.m_Bvh = (geom.m_pBvh != NULL) ? geom.m_BvhSize : 0;
+    header.m_Name = static_cast<uint32_t>(mesh.size());
+    for( int i = 0; i < 3; i++ )
+        header.m_Size[i] = static_cast<float>(geom.m_Size[i]);
+    header.m_Radius = static_cast<float>(geom.m_Radius);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(mesh.data(), static_cast<std::streamsize>(mesh.size()));
+    if( ! geom.m_Vertices.empty() )
+        file.write(reinterpret_cast<const char*>(&geom.m_Vertices[0]), static_cast<std::streamsize>(geom.m_Vertices.size() * sizeof(btScalar)));
+    if( ! geom.m_Indices.empty() )
+        file.write(reinterpret_cast<const char*>(&geom.m_Indices[0]), static_cast<std::streamsize>(geom.m_Indices.size() * sizeof(int)));
+    if( header.m_Bvh > 0 )
+        file.write(static_cast<const char*>(geom.m_pBvhBuffer), header.m_Bvh);
+    file.close();
+
+    if( ! file )
+        return log_error("Can't write shapes cache \"%s\"", path.c_str());
+
+    fs::rename(tmp_path, path, ec);
+    if( ec )
+        return log_error("Can't replace shapes cache \"%s\": %s", path.c_str(), ec.message().c_str());
+
+    return true;
+}
+
+fs::path CShapeCache::filePath(const std::string& mesh) const
+{
+    std::string name;
+    for( std::string::const_iterator it = mesh.begin(); it != mesh.end(); ++it )
+    {
+        unsigned char c = static_cast<unsigned char>(*it);
+        if( (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '_' )
+            name += *it;
+        else
+        {
+            char escaped[4];
+            std::snprintf(escaped, sizeof(escaped), "%%%02X", c);
+            name += escaped;
+        }
+    }
+
+    return m_Path / (name + ".tdsh");
+}
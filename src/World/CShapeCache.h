@@ -0,0 +1,239 @@
+/**
+ * @file    CShapeCache.h
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Shared collision shapes of meshes
+ *
+ *
+ */
+
+#ifndef CSHAPECACHE_H
+#define CSHAPECACHE_H
+
+#include "Common.h"
+
+#include <OGRE/Ogre.h>
+
+#include "btogre/BtOgreGP.h"
+
+#include <cstdint>
+#include <mutex>
+
+/** @brief Header of mesh geometry cache file
+ *
+ * File is header, then mesh name, vertices (btScalar x, y, z), triangle
+ * indices (int32) and serialized btOptimizedBvh of trimesh shape in host
+ * byte order.
+ */
+struct SShapeCacheHeader
+{
+    char                m_Magic[4];    ///< File signature "TDSH"
+    uint32_t            m_Version;     ///< Format version
+    uint32_t            m_Bullet;      ///< Bullet version, BVH layout depends on it
+    uint32_t            m_Scalar;      ///< Size of btScalar
+    uint64_t            m_FileSize;    ///< Size of mesh file
+    uint64_t            m_Hash;        ///< Content hash of mesh file (FNV-1a)
+    uint32_t            m_Vertices;    ///< Number of vertices
+    uint32_t            m_Indices;     ///< Number of indices
+    uint32_t            m_Bvh;         ///< Size of serialized BVH, 0 if trimesh was not built
+    uint32_t            m_Name;        ///< Length of mesh name
+    float               m_Size[3];     ///< Size of mesh bounding box
+    float               m_Radius;      ///< Radius of bounding sphere
+};
+
+/** @brief Collision shapes of meshes shared between objects
+ *
+ *  Vertices of mesh are read back from its buffers once, shapes are
+ * created once for every mesh, kind and scale and shared by all objects
+ * and worlds - they must not be changed. Mesh geometry and trimesh BVH
+ * are cached on disk, next start does not read back buffers and does not
+ * build BVH while content of mesh file is not changed.
+ */
+class CShapeCache
+{
+public:
+    /** @brief Kind of shape
+     */
+    enum ShapeKind
+    {
+        SHAPE_SPHERE   = 0, ///< Bounding sphere
+        SHAPE_BOX      = 1, ///< Bounding box
+        SHAPE_CYLINDER = 2, ///< Bounding cylinder along X
+        SHAPE_CONVEX   = 3, ///< Convex hull of vertices
+        SHAPE_TRIMESH  = 4  ///< Static triangle mesh
+    };
+
+    /** @brief Create cache
+     *
+     * @param path - Directory of geometry cache files, empty - without disk cache
+     */
+    CShapeCache(const char* path);
+
+    /** @brief Delete all shapes
+     *
+     * Bodies using shapes must be deleted before.
+     */
+    ~CShapeCache();
+
+    /** @brief Shared shape of mesh
+     *
+     * @param mesh - Name of mesh resource
+     * @param kind - Kind of shape
+     * @param scale - Local scaling of shape
+     * @return btCollisionShape* - Owned by cache
+     */
+    btCollisionShape* shape(const char* mesh, ShapeKind kind, const btVector3& scale = btVector3(1.0f, 1.0f, 1.0f));
+
+    /** @brief Size of mesh bounding box
+     *
+     * @param mesh - Name of mesh resource
+     * @return Ogre::Vector3
+     */
+    Ogre::Vector3 size(const char* mesh);
+
+    /** @brief Number of created shapes
+     *
+     * @return size_t
+     */
+    size_t shapes();
+
+    static const char       s_Magic[4]; ///< File signature
+    static const uint32_t   s_Version;  ///< Current format version
+
+private:
+    /** @brief Fake copy constructor
+     *
+     * @param obj
+     *
+     * @todo create copy constructor
+     */
+    CShapeCache(const CShapeCache& obj);
+    /** @brief Fake eq operator
+     *
+     * @param obj
+     *
+     * @toto create eq copy operator
+     */
+    CShapeCache& operator=(const CShapeCache& obj);
+
+    /** @brief Geometry of mesh
+     */
+    struct SGeometry
+    {
+        SGeometry()
+            : m_Vertices(), m_Indices(), m_Size(0.0f, 0.0f, 0.0f), m_Radius(0.0f), m_FileSize(0), m_Hash(0)
+            , m_pArray(), m_pBvh(), m_pBvhBuffer(), m_BvhSize(0) {  }
+        ~SGeometry();
+
+        std::vector<btScalar>       m_Vertices;   ///< Vertices x, y, z
+        std::vector<int>            m_Indices;    ///< Triangle indices
+        btVector3                   m_Size;       ///< Size of bounding box
+        btScalar                    m_Radius;     ///< Radius of bounding sphere
+        uint64_t                    m_FileSize;   ///< Size of mesh file
+        uint64_t                    m_Hash;       ///< Content hash of mesh file
+        btTriangleIndexVertexArray* m_pArray;     ///< Triangles of trimesh shape
+        btOptimizedBvh*             m_pBvh;       ///< BVH of trimesh shape, placed in m_pBvhBuffer
+        void*                       m_pBvhBuffer; ///< Aligned buffer of serialized BVH
+        uint32_t                    m_BvhSize;    ///< Size of BVH buffer
+
+    private:
+        /** @brief Fake copy constructor
+         *
+         * @param obj
+         *
+         * @todo create copy constructor
+         */
+        SGeometry(const SGeometry& obj);
+        /** @brief Fake eq operator
+         *
+         * @param obj
+         *
+         * @toto create eq copy operator
+         */
+        SGeometry& operator=(const SGeometry& obj);
+    };
+
+    /** @brief Key of shape
+     */
+    struct SShapeKey
+    {
+        SShapeKey(const std::string& mesh, ShapeKind kind, const btVector3& scale)
+            : m_Mesh(mesh), m_Kind(kind), m_Scale(scale) {  }
+
+        bool operator<(const SShapeKey& key) const;
+
+        std::string     m_Mesh;  ///< Name of mesh resource
+        ShapeKind       m_Kind;  ///< Kind of shape
+        btVector3       m_Scale; ///< Local scaling
+    };
+
+    /** @brief Shared shape, created if absent
+     *
+     * @param mesh - Name of mesh resource
+     * @param kind - Kind of shape
+     * @param scale - Local scaling
+     * @return btCollisionShape*
+     *
+     * Called under lock.
+     */
+    btCollisionShape* get(const std::string& mesh, ShapeKind kind, const btVector3& scale);
+
+    /** @brief Geometry of mesh, read back or restored from disk once
+     *
+     * @param mesh - Name of mesh resource
+     * @return SGeometry&
+     *
+     * Called under lock.
+     */
+    SGeometry& geometry(const std::string& mesh);
+
+    /** @brief Create shape of geometry
+     *
+     * @param mesh - Name of mesh resource
+     * @param kind - Kind of shape
+     * @param scale - Local scaling
+     * @return btCollisionShape*
+     *
+     * Called under lock.
+     */
+    btCollisionShape* create(const std::string& mesh, ShapeKind kind, const btVector3& scale);
+
+    /** @brief Read geometry cache file
+     *
+     * @param mesh - Name of mesh resource
+     * @param geom - Geometry with size and hash of mesh file
+     * @return bool - false if file is absent, corrupted or outdated
+     */
+    bool load(const std::string& mesh, SGeometry& geom) const;
+
+    /** @brief Write geometry cache file
+     *
+     * @param mesh - Name of mesh resource
+     * @param geom - Geometry
+     * @return bool
+     */
+    bool save(const std::string& mesh, const SGeometry& geom) const;
+
+    /** @brief Path of geometry cache file
+     *
+     * @param mesh - Name of mesh resource
+     * @return fs::path
+     *
+     * Characters except letters, digits, '.', '-' and '_' are escaped as
+     * %XX, so different names never share a file.
+     */
+    fs::path filePath(const std::string& mesh) const;
+
+    fs::path                                        m_Path;       ///< Directory of cache files
+    std::map<std::string, SGeometry*>               m_Geometries; ///< Geometry of meshes
+    std::map<SShapeKey, btCollisionShape*>          m_Shapes;     ///< Shared shapes
+    std::vector<btCollisionShape*>                  m_Created;    ///< Shapes in order of creation
+    std::mutex                                      m_Mutex;      ///< Cache lock
+};
+
+#endif // CSHAPECACHE_H
@@ -12,72 +12,200 @@
  *
  */
 
+#define LOG_SUBSYSTEM Common::CLog::SYS_WORLD ///< Log subsystem of file
+
 #include "CWorld.h"
 #include "CGame.h"
+#include "CProfiler.h"
+
+#ifdef CONFIG_BULLET_MULTITHREADED
+#   include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#   include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#   include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#endif
 
 CWorld::CWorld(const Ogre::Vector3& pos)
     : CObject("World", *this, pos)
     , m_pPhyWorld()
     , m_pGravityField()
-    , m_pDbgDraw()
+    , m_pKernels()
+    , m_Bodies()
+    , m_States()
+    , m_ObjectPools()
     , m_pBroadphase()
+    , m_pGhostPairCallback()
     , m_pCollisionConfig()
     , m_pDispatcher()
     , m_pSolver()
+    , m_pSolverPool()
+    , m_pDbgDraw()
 {
     m_pNode = m_pGame->m_pSceneMgr->getRootSceneNode()->createChildSceneNode(m_Position);
 
-    // Bullet initialisation.
-    m_pBroadphase = new btAxisSweep3(btVector3(-10000,-10000,-10000), btVector3(10000,10000,10000), 1024);
+    // Bullet initialisation. Every cube takes 7 broadphase handles (body and gravity elements)
+    m_pBroadphase = createBroadphase(m_pGame->config("physics").child("broadphase"));
+    m_pGhostPairCallback = new btGhostPairCallback();
+    m_pBroadphase->getOverlappingPairCache()->setInternalGhostPairCallback(m_pGhostPairCallback);
     m_pCollisionConfig = new btDefaultCollisionConfiguration();
-    m_pDispatcher = new btCollisionDispatcher(m_pCollisionConfig);
-    m_pSolver = new btSequentialImpulseConstraintSolver();
 
-    m_pPhyWorld = new btDiscreteDynamicsWorld(m_pDispatcher, m_pBroadphase, m_pSolver, m_pCollisionConfig);
+#ifdef CONFIG_BULLET_MULTITHREADED
+    if( m_pGame->physicsThreads() > 0 )
+    {
+        // Narrowphase, islands solving and integration are split between Bullet task scheduler threads
+        btConstraintSolverPoolMt* solver_pool = new btConstraintSolverPoolMt(static_cast<int>(m_pGame->physicsThreads()));
+        m_pSolverPool = solver_pool;
+        m_pDispatcher = new btCollisionDispatcherMt(m_pCollisionConfig, 40);
+        m_pSolver = new btSequentialImpulseConstraintSolverMt();
+
+        m_pPhyWorld = new btDiscreteDynamicsWorldMt(m_pDispatcher, m_pBroadphase, solver_pool, m_pSolver, m_pCollisionConfig);
+    }
+    else
+#endif
+    {
+        m_pDispatcher = new btCollisionDispatcher(m_pCollisionConfig);
+        m_pSolver = new btSequentialImpulseConstraintSolver();
+
+        m_pPhyWorld = new btDiscreteDynamicsWorld(m_pDispatcher, m_pBroadphase, m_pSolver, m_pCollisionConfig);
+    }
     m_pPhyWorld->setGravity(btVector3(0,0,0));
-    m_pDbgDraw = new BtOgre::DebugDrawer(m_pGame->m_pSceneMgr->getRootSceneNode(), m_pPhyWorld);
 
-    m_pDbgDraw->setDebugMode(true);
-    m_pPhyWorld->setDebugDrawer(m_pDbgDraw);
+    // Nothing to draw without render system
+    if( ! m_pGame->headless() )
+    {
+        m_pDbgDraw = new CPhysicsDebugDrawer(m_pPhyWorld, m_pGame->m_pSceneMgr, m_pGame->config("physics").child("debug"));
+        m_pPhyWorld->setDebugDrawer(m_pDbgDraw);
+    }
 
     m_pGravityField = new CGravityField(this, 20.0f);
+    m_pKernels = new CKernelSystem(this);
+}
 
-    // Create scene
-    attachChild(new CObjectKernel(*this, 20, Ogre::Vector3(0.0f, 200.0f, 0.0f)));
-    attachChild(new CObjectCube(*this, CObjectCube::CCUBE, Ogre::Vector3(0.0f, 0.0f, 0.0f)));
+btBroadphaseInterface* CWorld::createBroadphase(pugi::xml_node config)
+{
+    std::string type = config.child_value("type");
+    if( type.empty() )
+        type = "auto";
+
+    // Without extents world is unbounded
+    bool bounded = *config.child_value("min") && *config.child_value("max");
+    btVector3 min = BtOgre::Convert::toBullet(Ogre::StringConverter::parseVector3(config.child_value("min")));
+    btVector3 max = BtOgre::Convert::toBullet(Ogre::StringConverter::parseVector3(config.child_value("max")));
+    uint max_handles = 16384;
+    if( *config.child_value("max_handles") )
+        max_handles = Ogre::StringConverter::parseUnsignedInt(config.child_value("max_handles"), max_handles);
+
+    if( bounded && !((min.x() < max.x()) && (min.y() < max.y()) && (min.z() < max.z())) )
+    {
+        log_warn("Bad broadphase extents - world is unbounded");
+        bounded = false;
+    }
+
+    if( max_handles == 0 )
+    {
+        log_warn("Bad broadphase max handles 0 - using 16384");
+        max_handles = 16384;
+    }
+
+    if( type == "auto" )
+        type = (bounded && (max_handles <= 16384)) ? "axis_sweep" : "dbvt";
+
+    if( type == "axis_sweep" )
+    {
+        if( bounded )
+        {
+            log_info("Broadphase: axis sweep, %u handles", max_handles);
+            if( max_handles < 32767 )
+                return new btAxisSweep3(min, max, static_cast<unsigned short>(max_handles));
+            return new bt32BitAxisSweep3(min, max, max_handles);
+        }
+        log_warn("Axis sweep broadphase needs world extents - using dbvt");
+    }
+    else if( type != "dbvt" )
+        log_warn("Unknown broadphase type \"%s\" - using dbvt", type.c_str());
+
+    log_info("Broadphase: dynamic AABB tree");
+    return new btDbvtBroadphase();
 }
 
 void CWorld::init()
 {
+    // Create scene
+    spawn<CObjectKernel>(20, Ogre::Vector3(0.0f, 200.0f, 0.0f));
+    spawn<CObjectCube>(CObjectCube::CCUBE, Ogre::Vector3(0.0f, 0.0f, 0.0f));
+}
+
+CPool* CWorld::objectPool(size_t size, size_t align)
+{
+    for( std::vector<CPool*>::iterator it = m_ObjectPools.begin(); it != m_ObjectPools.end(); ++it )
+    {
+        if( ((*it)->size() >= size) && ((*it)->size() - size < align) && ((*it)->align() >= align) )
+            return *it;
+    }
+
+    m_ObjectPools.push_back(new CPool(size, align));
+    return m_ObjectPools.back();
 }
 
 CWorld::~CWorld()
 {
+    // Objects are removed from field and physics while world exists
+    clearChildrens();
+    for( std::vector<CPool*>::iterator it = m_ObjectPools.begin(); it != m_ObjectPools.end(); ++it )
+        delete *it;
+
     //Free Bullet stuff
+    delete m_pKernels;
     delete m_pGravityField;
     delete m_pDbgDraw;
     delete m_pPhyWorld;
     delete m_pSolver;
+    delete m_pSolverPool;
     delete m_pDispatcher;
     delete m_pCollisionConfig;
     delete m_pBroadphase;
+    delete m_pGhostPairCallback;
 }
 
-void CWorld::update(const Ogre::Real time_since_last_frame)
+void CWorld::update(const Ogre::Real tick, CThreadPool* pPool)
 {
-    // Check ForceFields
-    m_pGravityField->catchFieldContact();
+    PROFILE_ZONE("CWorld::update");
 
-    //Update Bullet world. Don't forget the debugDrawWorld() part!
-    m_pPhyWorld->stepSimulation(time_since_last_frame, 10);
-    m_pPhyWorld->debugDrawWorld();
+    // Previous tick state for interpolation
+    saveState();
 
-    m_pDbgDraw->step();
+    // Exactly one fixed step per tick, motion states get not extrapolated transforms
+    {
+        PROFILE_ZONE("stepSimulation");
+        m_pPhyWorld->stepSimulation(tick, 1, tick);
+    }
 
-    // Update childrens
-    for( m_itChildrens = m_Childrens.begin() ; m_itChildrens < m_Childrens.end(); m_itChildrens++ )
-        (*m_itChildrens)->update(time_since_last_frame);
+    // Check ForceFields by contacts of this step
+    {
+        PROFILE_ZONE("catchFieldContact");
+        m_pGravityField->catchFieldContact();
+    }
+
+    // Update objects by systems
+    m_pKernels->update(tick, m_pGame->m_pCamera->getDirection(), pPool);
 
     // Clear object in gravity fields map
     m_pGravityField->clearObjectsInGravityField();
 }
+
+void CWorld::interpolate(const Ogre::Real alpha)
+{
+    PROFILE_ZONE("CWorld::interpolate");
+
+    CObject::interpolate(alpha);
+    m_pKernels->draw();
+
+    // Only shapes near camera, not whole world
+    if( m_pDbgDraw != NULL )
+        m_pDbgDraw->draw(m_pGame->m_pCamera);
+}
+
+void CWorld::physicsDebug(bool enabled)
+{
+    if( m_pDbgDraw != NULL )
+        m_pDbgDraw->enabled(enabled);
+}
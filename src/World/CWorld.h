@@ -17,12 +17,17 @@
 
 #include "Common.h"
 
+#include "pugixml/pugixml.hpp"
+
 #include "btogre/BtOgrePG.h"
 #include "btogre/BtOgreGP.h"
 #include "btogre/BtOgreExtras.h"
 
 #include "CObject.h"
 #include "CGravityField.h"
+#include "CThreadPool.h"
+#include "World/CKernelSystem.h"
+#include "World/CPhysicsDebugDrawer.h"
 
 #include "World/CObjectCube.h"
 #include "World/CObjectKernel.h"
@@ -44,30 +49,120 @@ public:
     ~CWorld();
 
 
-    /** @brief Update object data, it may be animation or just object translation or so on
+    /** @brief Run one fixed simulation tick
      *
-     * @param time_since_last_frame
+     * @param tick - Tick length in seconds
      * @return void
      *
      */
-    void update(const Ogre::Real time_since_last_frame);
+    void update(const Ogre::Real tick) { update(tick, NULL); }
 
-    /** @brief Initialize object
+    /** @brief Run one fixed simulation tick
+     *
+     * @param tick - Tick length in seconds
+     * @param pPool - Threads for batches of world systems, NULL - update in caller thread
+     * @return void
+     *
+     * Objects of world are updated by world systems in batches, not by
+     * their update().
+     */
+    void update(const Ogre::Real tick, CThreadPool* pPool);
+
+    /** @brief Update scene between simulation ticks and draw physics debug
+     *
+     * @see CObject::interpolate()
+     */
+    void interpolate(const Ogre::Real alpha);
+
+    /** @brief Physics debug drawing is enabled
+     *
+     * @return bool - false in headless mode
+     */
+    inline bool physicsDebug() const { return (m_pDbgDraw != NULL) && m_pDbgDraw->enabled(); }
+
+    /** @brief Enable or disable physics debug drawing, ignored in headless mode
+     *
+     * @param enabled - New state
+     * @return void
+     */
+    void physicsDebug(bool enabled);
+
+    /** @brief Create default world scene
      *
      * @return void
      *
      */
     void init();
 
+    /** @brief Create broadphase by config
+     *
+     * @param config - Broadphase config node (type, min, max, max_handles)
+     * @return btBroadphaseInterface*
+     *
+     * Type "axis_sweep" needs bounded world and fixed number of handles,
+     * "dbvt" grows without limits. Type "auto" selects axis sweep only for
+     * bounded worlds with not more than 16384 handles.
+     */
+    static btBroadphaseInterface* createBroadphase(pugi::xml_node config);
+
+    /** @brief Create object in world pool and attach it to world
+     *
+     * @param args - Arguments of object constructor after world
+     * @return T*
+     *
+     * Memory of despawned object is reused by next object of the same size.
+     */
+    template<typename T, typename... Args>
+    T* spawn(Args&&... args)
+    {
+        CPool* pool = objectPool(sizeof(T), __alignof__(T));
+        void* block = pool->alloc();
+        T* obj;
+        try {
+            obj = new(block) T(*this, std::forward<Args>(args)...);
+        }
+        catch( ... ) {
+            pool->release(block);
+            throw;
+        }
+        obj->setPool(pool);
+        attachChild(obj);
+
+        return obj;
+    }
+
+    /** @brief Destroy world object and return its memory to pools
+     *
+     * @param pObject - Child object of world
+     * @return void
+     *
+     * @see CObject::removeChild()
+     */
+    void despawn(CObject* pObject){ removeChild(pObject); }
+
     btDiscreteDynamicsWorld*              m_pPhyWorld;     ///< Physical World
     CGravityField*                        m_pGravityField; ///< World gravity field
+    CKernelSystem*                        m_pKernels;      ///< Movement of world kernels
+    CObjectPool<btRigidBody>              m_Bodies;        ///< Rigid bodies of objects
+    CObjectPool<BtOgre::RigidBodyState>   m_States;        ///< Motion states of objects
 
 private:
-    BtOgre::DebugDrawer*                  m_pDbgDraw;      ///< Debug drawer
-    btAxisSweep3*                         m_pBroadphase;      ///< Bullet broadphase
+    /** @brief Pool of objects with size and alignment, created if absent
+     *
+     * @param size - Size of object
+     * @param align - Alignment of object
+     * @return CPool*
+     */
+    CPool* objectPool(size_t size, size_t align);
+
+    std::vector<CPool*>                   m_ObjectPools;   ///< Memory of objects by size
+    btBroadphaseInterface*                m_pBroadphase;      ///< Bullet broadphase
+    btGhostPairCallback*                  m_pGhostPairCallback; ///< Keeps overlapping lists of gravity elements
     btDefaultCollisionConfiguration*      m_pCollisionConfig; ///< Bullet collision config
     btCollisionDispatcher*                m_pDispatcher;      ///< Bullet dispatcher
-    btSequentialImpulseConstraintSolver*  m_pSolver;          ///< Bullet solver
+    btConstraintSolver*                   m_pSolver;          ///< Bullet solver
+    btConstraintSolver*                   m_pSolverPool;      ///< Solvers of islands for multithreaded world
+    CPhysicsDebugDrawer*                  m_pDbgDraw;         ///< Physics debug drawer, NULL in headless mode
 
     /** @brief Fake copy constructor
      *
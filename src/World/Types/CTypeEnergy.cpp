@@ -12,6 +12,8 @@
  *
  */
 
+#define LOG_SUBSYSTEM Common::CLog::SYS_WORLD ///< Log subsystem of file
+
 #include "World/Types/CTypeEnergy.h"
 
 CTypeEnergy::CTypeEnergy()
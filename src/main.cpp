@@ -27,7 +27,7 @@ Common::SignalTranslator<Common::FloatingPointException> g_objFloatingPointExcep
  * @return int
  *
  */
-int main(int, char**)
+int main(int argc, char** argv)
 #else
 /** @brief Main started function
  *
@@ -42,6 +42,9 @@ INT WINAPI WinMain( HINSTANCE hInst, HINSTANCE, LPSTR strCmdLine, INT )
     log_notice("Starting %s v%s", CONFIG_TD_FULLNAME, CONFIG_TD_VERSION);
 
     try {
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32
+        CGame::getInstance()->loadArgs(argc, argv);
+#endif
         if( CGame::getInstance()->initialise() )
             CGame::getInstance()->start();
     }
@@ -63,6 +66,9 @@ INT WINAPI WinMain( HINSTANCE hInst, HINSTANCE, LPSTR strCmdLine, INT )
     // Destroy game in the end
     CGame::destroyInstance();
 
+    // Write all queued messages
+    Common::CLog::stop();
+
     log_notice("See you...");
 
     return 0;
@@ -0,0 +1,107 @@
+/**
+ * @file    logdump.cpp
+ * @date    2026-10-18T12:40:11+0400
+ *
+ * @author  Rabits <home.rabits@gmail.com>
+ * @copyright GNU General Public License, version 3 <http://www.gnu.org/licenses/>
+ *
+ * This file is a part of Total Destruction project <http://www.rabits.ru/td>
+ *
+ * @brief   Binary log decoder
+ *
+ * Usage: td_logdump <binary log> [minimal level number]
+ */
+
+#include "CLogFormat.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using Common::CLogFormat;
+
+/** @brief Read value from binary log
+ */
+template<typename T> bool read(FILE* file, T& value)
+{
+    return std::fread(&value, sizeof(T), 1, file) == 1;
+}
+
+/** @brief Decode binary log into text lines
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main(int argc, char** argv)
+{
+    if( argc < 2 )
+    {
+        std::fprintf(stderr, "Usage: %s <binary log> [minimal level 1-8]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* file = std::fopen(argv[1], "rb");
+    if( file == NULL )
+    {
+        std::fprintf(stderr, "Can't open \"%s\"\n", argv[1]);
+        return 1;
+    }
+    if( ! CLogFormat::readHeader(file) )
+    {
+        std::fprintf(stderr, "\"%s\" is not a binary log of supported version\n", argv[1]);
+        return 1;
+    }
+
+    unsigned int min_level = (argc > 2) ? static_cast<unsigned int>(std::atoi(argv[2])) : 0;
+
+    std::vector<std::string> formats;
+    std::vector<char> args;
+    char text[4096];
+    uint8_t type;
+    while( read(file, type) )
+    {
+        if( type == CLogFormat::RECORD_FORMAT )
+        {
+            uint32_t id;
+            uint16_t len;
+            if( ! read(file, id) || ! read(file, len) )
+                break;
+            std::string format(len, '\0');
+            if( len > 0 && std::fread(&format[0], 1, len, file) != len )
+                break;
+            if( formats.size() <= id )
+                formats.resize(id + 1);
+            formats[id] = format;
+        }
+        else if( type == CLogFormat::RECORD_MESSAGE )
+        {
+            uint32_t time, id;
+            uint8_t level, subsystem;
+            uint16_t size;
+            if( ! read(file, time) || ! read(file, level) || ! read(file, subsystem) || ! read(file, id) || ! read(file, size) )
+                break;
+            args.resize(size);
+            if( size > 0 && std::fread(&args[0], 1, size, file) != size )
+                break;
+
+            if( level < min_level )
+                continue;
+
+            const char* format = (id < formats.size()) ? formats[id].c_str() : "<unknown format>";
+            CLogFormat::unpack(text, sizeof(text), format, args.empty() ? NULL : &args[0], args.size());
+            std::printf("[%06u.%03u] %6s %5s: %s\n", time/1000, time%1000, CLogFormat::levelName(level),
+                        CLogFormat::subsystemName(subsystem), text);
+        }
+        else
+        {
+            std::fprintf(stderr, "Corrupted record at offset %ld\n", std::ftell(file) - 1);
+            std::fclose(file);
+            return 1;
+        }
+    }
+
+    std::fclose(file);
+
+    return 0;
+}